@@ -0,0 +1,371 @@
+#include "AllPairsShortestPaths.h"
+#include "CpuFeatures.h"
+#include "Parallel.h"
+#include "ShortestPathEngine.h"
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iostream>
+
+static constexpr unsigned int kAllPairsFileMagic = 0x31535041; // "APS1"
+
+AllPairsShortestPaths::AllPairsShortestPaths()
+    : m_nodeCount{ 0 }, m_stride{ 0 }, m_negativeCycle{ false }, m_distances{}
+{}
+
+bool AllPairsShortestPaths::computeFloydWarshall(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented)
+{
+    clear();
+    const unsigned int blockCount = (nodeCount + kBlockSize - 1) / kBlockSize;
+    const unsigned int stride = blockCount * kBlockSize;
+    m_distances.assign(static_cast<std::size_t>(stride) * stride, kUnreachable);
+    for (unsigned int nodeID = 0; nodeID < stride; ++nodeID)
+    {
+        m_distances[static_cast<std::size_t>(nodeID) * stride + nodeID] = 0;
+    }
+    for (const Edge& edge : edges)
+    {
+        unsigned int startNodeID = edge.getStartNode()->getInternalID();
+        unsigned int endNodeID = edge.getEndNode()->getInternalID();
+        int& forward = m_distances[static_cast<std::size_t>(startNodeID) * stride + endNodeID];
+        forward = std::min(forward, edge.getWeight());
+        if (!oriented)
+        {
+            int& backward = m_distances[static_cast<std::size_t>(endNodeID) * stride + startNodeID];
+            backward = std::min(backward, edge.getWeight());
+        }
+    }
+
+    auto block = [&](unsigned int rowBlock, unsigned int columnBlock)
+    {
+        return m_distances.data() + (static_cast<std::size_t>(rowBlock) * stride + columnBlock) * kBlockSize;
+    };
+
+    for (unsigned int pivotBlock = 0; pivotBlock < blockCount; ++pivotBlock)
+    {
+        int* pivot = block(pivotBlock, pivotBlock);
+        relaxBlock(pivot, pivot, pivot, stride);
+
+        // the pivot row and column blocks only depend on the pivot block
+        parallelFor(0, 2 * blockCount, [&](unsigned int task)
+        {
+            unsigned int otherBlock = task / 2;
+            if (otherBlock == pivotBlock)
+            {
+                return;
+            }
+            if (task % 2 == 0)
+            {
+                int* rowBlock = block(pivotBlock, otherBlock);
+                relaxBlock(rowBlock, pivot, rowBlock, stride);
+            }
+            else
+            {
+                int* columnBlock = block(otherBlock, pivotBlock);
+                relaxBlock(columnBlock, columnBlock, pivot, stride);
+            }
+        }, 1);
+
+        parallelFor(0, blockCount * blockCount, [&](unsigned int task)
+        {
+            unsigned int rowBlock = task / blockCount;
+            unsigned int columnBlock = task % blockCount;
+            if (rowBlock != pivotBlock && columnBlock != pivotBlock)
+            {
+                relaxBlock(block(rowBlock, columnBlock), block(rowBlock, pivotBlock), block(pivotBlock, columnBlock), stride);
+            }
+        }, 1);
+
+        for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+        {
+            if (m_distances[static_cast<std::size_t>(nodeID) * stride + nodeID] < 0)
+            {
+                clear();
+                m_negativeCycle = true;
+                std::cout << "The graph has a negative cycle\n";
+                return false;
+            }
+        }
+    }
+
+    m_nodeCount = nodeCount;
+    m_stride = stride;
+    return true;
+}
+
+bool AllPairsShortestPaths::computeJohnson(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented)
+{
+    clear();
+    std::vector<long long> potentials;
+    if (!computePotentials(nodeCount, edges, oriented, potentials))
+    {
+        m_negativeCycle = true;
+        std::cout << "The graph has a negative cycle\n";
+        return false;
+    }
+
+    CompactGraph graph;
+    buildReweightedGraph(nodeCount, edges, oriented, potentials, graph);
+
+    m_distances.resize(static_cast<std::size_t>(nodeCount) * nodeCount);
+    computeRows(graph, potentials, 0, nodeCount, m_distances.data());
+    m_nodeCount = nodeCount;
+    m_stride = nodeCount;
+    return true;
+}
+
+bool AllPairsShortestPaths::streamJohnson(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented, const std::string& filePath)
+{
+    clear();
+    std::vector<long long> potentials;
+    if (!computePotentials(nodeCount, edges, oriented, potentials))
+    {
+        m_negativeCycle = true;
+        std::cout << "The graph has a negative cycle\n";
+        return false;
+    }
+
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Can't open file at: " << filePath << "\n";
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&kAllPairsFileMagic), sizeof(kAllPairsFileMagic));
+    file.write(reinterpret_cast<const char*>(&nodeCount), sizeof(nodeCount));
+
+    CompactGraph graph;
+    buildReweightedGraph(nodeCount, edges, oriented, potentials, graph);
+
+    std::vector<int> rows(static_cast<std::size_t>(std::min(nodeCount, kStreamedRows)) * nodeCount);
+    for (unsigned int firstSource = 0; firstSource < nodeCount && file; firstSource += kStreamedRows)
+    {
+        unsigned int lastSource = std::min(nodeCount, firstSource + kStreamedRows);
+        computeRows(graph, potentials, firstSource, lastSource, rows.data());
+        file.write(reinterpret_cast<const char*>(rows.data()), static_cast<std::size_t>(lastSource - firstSource) * nodeCount * sizeof(int));
+    }
+    return static_cast<bool>(file);
+}
+
+void AllPairsShortestPaths::clear()
+{
+    m_nodeCount = 0;
+    m_stride = 0;
+    m_negativeCycle = false;
+    m_distances.clear();
+}
+
+bool AllPairsShortestPaths::save(const std::string& filePath) const
+{
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Can't open file at: " << filePath << "\n";
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&kAllPairsFileMagic), sizeof(kAllPairsFileMagic));
+    file.write(reinterpret_cast<const char*>(&m_nodeCount), sizeof(m_nodeCount));
+    for (unsigned int sourceNodeID = 0; sourceNodeID < m_nodeCount && file; ++sourceNodeID)
+    {
+        file.write(reinterpret_cast<const char*>(m_distances.data() + static_cast<std::size_t>(sourceNodeID) * m_stride), m_nodeCount * sizeof(int));
+    }
+    return static_cast<bool>(file);
+}
+
+bool AllPairsShortestPaths::load(const std::string& filePath)
+{
+    clear();
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    unsigned int magic = 0, nodeCount = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&nodeCount), sizeof(nodeCount));
+    if (!file || magic != kAllPairsFileMagic)
+    {
+        return false;
+    }
+
+    m_distances.resize(static_cast<std::size_t>(nodeCount) * nodeCount);
+    file.read(reinterpret_cast<char*>(m_distances.data()), m_distances.size() * sizeof(int));
+    if (!file)
+    {
+        m_distances.clear();
+        return false;
+    }
+
+    m_nodeCount = nodeCount;
+    m_stride = nodeCount;
+    return true;
+}
+
+bool AllPairsShortestPaths::prefersFloydWarshall(unsigned int nodeCount, unsigned int arcCount)
+{
+    unsigned long long johnsonCost = static_cast<unsigned long long>(arcCount) * std::bit_width(nodeCount) * 8;
+    return johnsonCost >= static_cast<unsigned long long>(nodeCount) * nodeCount;
+}
+
+int AllPairsShortestPaths::getDistance(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    return m_distances[static_cast<std::size_t>(sourceNodeID) * m_stride + targetNodeID];
+}
+
+unsigned int AllPairsShortestPaths::getNodeCount() const
+{
+    return m_nodeCount;
+}
+
+bool AllPairsShortestPaths::hasNegativeCycle() const
+{
+    return m_negativeCycle;
+}
+
+// block[i][j] = min(block[i][j], rowBlock[i][k] + columnBlock[k][j]) with k outermost, so the block may alias either input
+void AllPairsShortestPaths::relaxBlock(int* block, const int* rowBlock, const int* columnBlock, unsigned int stride)
+{
+#if defined(HAS_AVX2_KERNELS)
+    if (isAvx2Supported())
+    {
+        relaxBlockAvx2(block, rowBlock, columnBlock, stride);
+        return;
+    }
+#endif
+    relaxBlockScalar(block, rowBlock, columnBlock, stride);
+}
+
+void AllPairsShortestPaths::relaxBlockScalar(int* block, const int* rowBlock, const int* columnBlock, unsigned int stride)
+{
+    for (unsigned int k = 0; k < kBlockSize; ++k)
+    {
+        const int* through = columnBlock + static_cast<std::size_t>(k) * stride;
+        for (unsigned int i = 0; i < kBlockSize; ++i)
+        {
+            const int toPivot = rowBlock[static_cast<std::size_t>(i) * stride + k];
+            if (toPivot == kUnreachable)
+            {
+                continue;
+            }
+
+            int* row = block + static_cast<std::size_t>(i) * stride;
+            for (unsigned int j = 0; j < kBlockSize; ++j)
+            {
+                int candidate = through[j] == kUnreachable ? kUnreachable : through[j] + toPivot;
+                row[j] = std::min(row[j], candidate);
+            }
+        }
+    }
+}
+
+#if defined(HAS_AVX2_KERNELS)
+// Eight columns per step; kBlockSize is a multiple of 8, so there is no scalar tail
+AVX2_TARGET void AllPairsShortestPaths::relaxBlockAvx2(int* block, const int* rowBlock, const int* columnBlock, unsigned int stride)
+{
+    static_assert(kBlockSize % 8 == 0);
+    const __m256i unreachable = _mm256_set1_epi32(kUnreachable);
+    for (unsigned int k = 0; k < kBlockSize; ++k)
+    {
+        const int* through = columnBlock + static_cast<std::size_t>(k) * stride;
+        for (unsigned int i = 0; i < kBlockSize; ++i)
+        {
+            const int toPivot = rowBlock[static_cast<std::size_t>(i) * stride + k];
+            if (toPivot == kUnreachable)
+            {
+                continue;
+            }
+
+            int* row = block + static_cast<std::size_t>(i) * stride;
+            const __m256i pivotDistance = _mm256_set1_epi32(toPivot);
+            for (unsigned int j = 0; j < kBlockSize; j += 8)
+            {
+                __m256i fromPivot = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(through + j));
+                __m256i candidate = _mm256_blendv_epi8(_mm256_add_epi32(fromPivot, pivotDistance), unreachable, _mm256_cmpeq_epi32(fromPivot, unreachable));
+                __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + j), _mm256_min_epi32(current, candidate));
+            }
+        }
+    }
+}
+#endif
+
+// Bellman-Ford from a virtual source joined to every node by a zero arc, stopping at the first round without changes.
+bool AllPairsShortestPaths::computePotentials(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented, std::vector<long long>& potentials)
+{
+    potentials.assign(nodeCount, 0);
+    for (unsigned int round = 0; round <= nodeCount; ++round)
+    {
+        bool changed = false;
+        for (const Edge& edge : edges)
+        {
+            unsigned int startNodeID = edge.getStartNode()->getInternalID();
+            unsigned int endNodeID = edge.getEndNode()->getInternalID();
+            if (potentials[startNodeID] + edge.getWeight() < potentials[endNodeID])
+            {
+                potentials[endNodeID] = potentials[startNodeID] + edge.getWeight();
+                changed = true;
+            }
+            if (!oriented && potentials[endNodeID] + edge.getWeight() < potentials[startNodeID])
+            {
+                potentials[startNodeID] = potentials[endNodeID] + edge.getWeight();
+                changed = true;
+            }
+        }
+
+        if (!changed)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// w + h(u) - h(v) is never negative. An undirected graph without negative cycles has no negative edge, so its potentials
+// are all zero and the arcs keep their weights.
+void AllPairsShortestPaths::buildReweightedGraph(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented
+                                                , const std::vector<long long>& potentials, CompactGraph& graph)
+{
+    graph.build(nodeCount, edges, oriented);
+    if (!oriented)
+    {
+        return;
+    }
+
+    for (unsigned int edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex)
+    {
+        unsigned int startNodeID = edges[edgeIndex].getStartNode()->getInternalID();
+        unsigned int endNodeID = edges[edgeIndex].getEndNode()->getInternalID();
+        long long weight = edges[edgeIndex].getWeight() + potentials[startNodeID] - potentials[endNodeID];
+        if (weight != std::max(0, edges[edgeIndex].getWeight()))
+        {
+            graph.setEdgeWeight(edgeIndex, startNodeID, endNodeID, static_cast<unsigned int>(weight));
+        }
+    }
+}
+
+void AllPairsShortestPaths::computeRows(const CompactGraph& graph, const std::vector<long long>& potentials
+                                       , unsigned int firstSource, unsigned int lastSource, int* rows)
+{
+    const unsigned int nodeCount = graph.getNodeCount();
+    std::vector<std::vector<unsigned int>> distances(getParallelThreadCount());
+
+    parallelForChunks(firstSource, lastSource, 1, [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+    {
+        for (unsigned int sourceNodeID = chunkBegin; sourceNodeID < chunkEnd; ++sourceNodeID)
+        {
+            ShortestPathEngine::computeDistances(graph, sourceNodeID, false, distances[threadIndex]);
+
+            int* row = rows + static_cast<std::size_t>(sourceNodeID - firstSource) * nodeCount;
+            for (unsigned int targetNodeID = 0; targetNodeID < nodeCount; ++targetNodeID)
+            {
+                unsigned int distance = distances[threadIndex][targetNodeID];
+                row[targetNodeID] = distance == PathQueryResult::kUnreachable
+                                  ? kUnreachable
+                                  : static_cast<int>(distance - potentials[sourceNodeID] + potentials[targetNodeID]);
+            }
+        }
+    });
+}
@@ -80,6 +80,7 @@ void Application::renderUI()
     if (m_state == State::GraphEditor)
     {
         renderGraphEditorUI();
+        renderGraphStatisticsUI();
     }
     else if (m_state == State::Maze)
     {
@@ -122,6 +123,11 @@ void Application::renderGraphEditorUI()
             m_graphEditor.getGraphData().setWeighted(false);
         }
     }
+    bool maintainTopologicalOrder = m_graphEditor.getGraphData().isMaintainingTopologicalOrder();
+    if (ImGui::Checkbox("Maintain topological order", &maintainTopologicalOrder))
+    {
+        m_graphEditor.getGraphData().setMaintainTopologicalOrder(maintainTopologicalOrder);
+    }
     if (ImGui::Button("clear"))
     {
         m_graphEditor.getGraphData().clear();
@@ -215,27 +221,43 @@ void Application::renderGraphEditorUI()
     }
     if (ImGui::Button("Topological sort"))
     {
-        const GraphNode* const selectedNode = m_graphEditor.getSelectedNode();
+        GraphData::TopologicalOrder topologicalOrder = m_graphEditor.getGraphData().topologicalLevels();
 
-        if (selectedNode)
+        if (!topologicalOrder.cycle.empty())
+        {
+            std::cout << "Can't perform topological sort, cycle found: ";
+            for (unsigned int node : topologicalOrder.cycle)
+            {
+                std::cout << node << " ";
+            }
+            std::cout << "\n";
+        }
+        else
         {
-            std::vector<unsigned int> topoSorted = m_graphEditor.getGraphData().topologicalSort(selectedNode);
-
             std::ofstream fout("res/topologicalSort/topoSort.txt");
 
             if (!fout.is_open())
             {
                 std::cout << "ERROR::FILE: could not open file\n";
-                return;
             }
 
-            for (unsigned int node : topoSorted)
+            for (unsigned int node : topologicalOrder.order)
             {
                 fout << node << " ";
                 std::cout << node << " ";
             }
             std::cout << "\n";
             fout << "\n";
+
+            for (unsigned int level = 0; level < topologicalOrder.levels.size(); ++level)
+            {
+                std::cout << "level " << level << ": ";
+                for (unsigned int node : topologicalOrder.levels[level])
+                {
+                    std::cout << node << " ";
+                }
+                std::cout << "\n";
+            }
         }
     }
     if (ImGui::Button("Check cycles oriented"))
@@ -269,6 +291,42 @@ void Application::renderGraphEditorUI()
             std::cout << "select the node first\n";
         }
     }
+    if (ImGui::Button("Can reach"))
+    {
+        unsigned int startNodeID;
+        std::cout << "start nodeID: ";
+        std::cin >> startNodeID;
+
+        unsigned int endNodeID;
+        std::cout << "end nodeID: ";
+        std::cin >> endNodeID;
+
+        const unsigned int nodeCount = static_cast<unsigned int>(m_graphEditor.getGraphData().getSize());
+        if (startNodeID < nodeCount && endNodeID < nodeCount)
+        {
+            std::cout << startNodeID << (m_graphEditor.getGraphData().canReach(startNodeID, endNodeID) ? " reaches " : " doesn't reach ") << endNodeID << "\n";
+        }
+        else
+        {
+            std::cout << "invalid nodeID\n";
+        }
+    }
+    if (ImGui::Button("Transitive closure"))
+    {
+        BitMatrix closure = m_graphEditor.getGraphData().transitiveClosure();
+        for (unsigned int startNodeID = 0; startNodeID < closure.getSize(); ++startNodeID)
+        {
+            std::cout << startNodeID << ":";
+            for (unsigned int endNodeID = 0; endNodeID < closure.getSize(); ++endNodeID)
+            {
+                if (closure.test(startNodeID, endNodeID))
+                {
+                    std::cout << " " << endNodeID;
+                }
+            }
+            std::cout << "\n";
+        }
+    }
     if (ImGui::Button("Inverse graph"))
     {
         m_graphEditor.getGraphData().inverseGraph();
@@ -326,7 +384,9 @@ void Application::renderGraphEditorUI()
         }
     }
 
-    if (m_graphEditor.getGraphData().isWeighted() && !m_graphEditor.getGraphData().isOriented())
+    const GraphData::Statistics& statistics = m_graphEditor.getGraphData().getStatistics();
+
+    if (statistics.weighted && !statistics.oriented && statistics.weakComponentCount == 1)
     {
         if (ImGui::Button("Generic MST"))
         {
@@ -389,26 +449,41 @@ void Application::renderGraphEditorUI()
         }
     }
     
-    if (m_graphEditor.getGraphData().isWeighted() && m_graphEditor.getGraphData().isOriented())
+    if (statistics.weighted && statistics.oriented)
     {
         if (ImGui::Button("Djikstra"))
         {
             unsigned int startNodeID;
             std::cout << "start nodeID: ";
             std::cin >> startNodeID;
-            const GraphNode* startNode = m_graphEditor.getGraphData().getNode(startNodeID);
 
             unsigned int endNodeID;
-            std::cout << "start nodeID: ";
+            std::cout << "end nodeID: ";
             std::cin >> endNodeID;
-            const GraphNode* endNode = m_graphEditor.getGraphData().getNode(endNodeID);
 
-            std::vector<unsigned int> minPath = m_graphEditor.getGraphData().dijkstraMinimumCost(startNode, endNode);
-            for (unsigned int nodeID : minPath)
+            const unsigned int nodeCount = static_cast<unsigned int>(m_graphEditor.getGraphData().getSize());
+            if (startNodeID < nodeCount && endNodeID < nodeCount)
             {
-                std::cout << nodeID << "\n";
+                m_graphEditor.showRoute(startNodeID, endNodeID);
             }
-            std::cout << "\n";
+            else
+            {
+                std::cout << "invalid nodeID\n";
+            }
+        }
+        if (ImGui::Button("Batch Djikstra"))
+        {
+            std::string queriesFilePath;
+            std::cout << "queries file (source and target per line): ";
+            std::cin >> queriesFilePath;
+            m_graphEditor.runBatchQueries(queriesFilePath);
+        }
+        if (ImGui::Button("All pairs shortest paths"))
+        {
+            std::string matrixFilePath;
+            std::cout << "distance matrix file: ";
+            std::cin >> matrixFilePath;
+            m_graphEditor.exportAllPairsShortestPaths(matrixFilePath);
         }
         if (ImGui::Button("Ford Fulkerson"))
         {
@@ -431,12 +506,49 @@ void Application::renderGraphEditorUI()
             }
             std::cout << "The max flow is " << maxFlow << "\n";
         }
+        if (ImGui::Button("Min cost flow"))
+        {
+            unsigned int sourceNodeID;
+            std::cout << "source nodeID: ";
+            std::cin >> sourceNodeID;
+
+            unsigned int sinkNodeID;
+            std::cout << "sink nodeID: ";
+            std::cin >> sinkNodeID;
+
+            std::string costsFilePath;
+            std::cout << "costs file (one cost per edge, in edge order): ";
+            std::cin >> costsFilePath;
+            m_graphEditor.runMinCostFlow(sourceNodeID, sinkNodeID, costsFilePath);
+        }
     }
 
 
     ImGui::End();
 }
 
+void Application::renderGraphStatisticsUI()
+{
+    const GraphData::Statistics& statistics = m_graphEditor.getGraphData().getStatistics();
+
+    ImGui::Begin("Statistics");
+    ImGui::Text("Nodes: %u", statistics.nodeCount);
+    ImGui::Text("Edges: %u", statistics.edgeCount);
+    ImGui::Text("Self loops: %u", statistics.selfLoopCount);
+    ImGui::Text("Sources: %u", statistics.sourceCount);
+    ImGui::Text("Sinks: %u", statistics.sinkCount);
+    ImGui::Text("Isolated nodes: %u", statistics.degreeHistogram.empty() ? 0u : statistics.degreeHistogram[0]);
+    ImGui::Text("Weak components: %u", statistics.weakComponentCount);
+    ImGui::Text("Max degree: %u", statistics.maxDegree);
+    ImGui::Text("Density: %.4f", statistics.density);
+    ImGui::Text("Dense mode: %s", m_graphEditor.getGraphData().isDenseMode() ? "on" : "off");
+
+    std::vector<float> histogram(statistics.degreeHistogram.begin(), statistics.degreeHistogram.end());
+    ImGui::PlotHistogram("Degrees", histogram.data(), static_cast<int>(histogram.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 80));
+
+    ImGui::End();
+}
+
 static std::string mazeFilePath{"res/maze/maze.txt"};
 void Application::renderMazeUI()
 {
@@ -456,6 +568,10 @@ void Application::renderMazeUI()
 }
 
 static std::string mapFilePath{"res/map/Harta_Luxemburg.xml"};
+static int isochroneDistance{ 5000 };
+static int alternativeRouteCount{ 3 };
+static double routeStart[2]{ 49.6116, 6.1319 };
+static double routeEnd[2]{ 49.4958, 5.9806 };
 void Application::renderMapUI()
 {
     ImGui::Begin("Map");
@@ -465,10 +581,45 @@ void Application::renderMapUI()
     {
         m_map.loadFromFile(mapFilePath);
     }
+
+    const char* routingAlgorithms[]{ "Dijkstra", "Bidirectional Dijkstra", "A*", "ALT", "Contraction hierarchy", "Customizable hierarchy" };
+    int routingAlgorithm = static_cast<int>(m_map.getRoutingAlgorithm());
+    if (ImGui::Combo("Routing", &routingAlgorithm, routingAlgorithms, IM_ARRAYSIZE(routingAlgorithms)))
+    {
+        m_map.setRoutingAlgorithm(static_cast<RoutingAlgorithm>(routingAlgorithm));
+    }
     if (ImGui::Button("solve"))
     {
         m_map.findMinDistance();
     }
+    ImGui::InputInt("Alternative routes", &alternativeRouteCount);
+    if (ImGui::Button("alternatives"))
+    {
+        m_map.findAlternativeRoutes(static_cast<unsigned int>(std::max(1, alternativeRouteCount)));
+    }
+    ImGui::InputScalarN("Start lat/long", ImGuiDataType_Double, routeStart, 2, nullptr, nullptr, "%.6f");
+    ImGui::InputScalarN("End lat/long", ImGuiDataType_Double, routeEnd, 2, nullptr, nullptr, "%.6f");
+    if (ImGui::Button("route coordinates"))
+    {
+        m_map.routeBetweenCoordinates({ routeStart[0], routeStart[1] }, { routeEnd[0], routeEnd[1] });
+    }
+    if (ImGui::Button("routing report"))
+    {
+        m_map.reportRoutingBenchmark(200);
+    }
+    ImGui::InputInt("Isochrone distance", &isochroneDistance);
+    if (ImGui::Button("isochrone"))
+    {
+        m_map.showIsochrone(static_cast<unsigned int>(std::max(0, isochroneDistance)));
+    }
+    if (ImGui::Button("traffic update"))
+    {
+        m_map.applyTrafficUpdate(0.1f);
+    }
+    if (ImGui::Button("distance table"))
+    {
+        m_map.exportDistanceTable(1000, mapFilePath.c_str() + std::string{ ".table" });
+    }
 
     ImGui::End();
 }
@@ -0,0 +1,50 @@
+#include "BatchQueryRunner.h"
+#include "Parallel.h"
+#include <chrono>
+
+BatchQueryRunner::BatchQueryRunner(const CompactGraph& graph)
+    : m_graph{ graph }, m_engines{}
+{}
+
+BatchQueryResult BatchQueryRunner::run(const std::vector<std::pair<unsigned int, unsigned int>>& queries, bool withPaths, QueuePolicy queuePolicy)
+{
+    BatchQueryResult result;
+    result.distances.assign(queries.size(), PathQueryResult::kUnreachable);
+    if (withPaths)
+    {
+        result.paths.resize(queries.size());
+    }
+
+    while (m_engines.size() < getParallelThreadCount())
+    {
+        m_engines.push_back(std::make_unique<ShortestPathEngine>(m_graph));
+    }
+    for (auto& engine : m_engines)
+    {
+        engine->setQueuePolicy(queuePolicy);
+    }
+
+    const unsigned int nodeCount = m_graph.getNodeCount();
+    auto start = std::chrono::steady_clock::now();
+    parallelForChunks(0, static_cast<unsigned int>(queries.size()), kQueriesPerChunk, [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+    {
+        ShortestPathEngine& engine = *m_engines[threadIndex];
+        for (unsigned int queryIndex = chunkBegin; queryIndex < chunkEnd; ++queryIndex)
+        {
+            const auto& [sourceNodeID, targetNodeID] = queries[queryIndex];
+            if (sourceNodeID >= nodeCount || targetNodeID >= nodeCount)
+            {
+                continue;
+            }
+
+            PathQueryResult path = engine.bidirectionalQuery(sourceNodeID, targetNodeID);
+            result.distances[queryIndex] = path.distance;
+            if (withPaths)
+            {
+                result.paths[queryIndex] = std::move(path);
+            }
+        }
+    });
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
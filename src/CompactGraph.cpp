@@ -0,0 +1,201 @@
+#include "CompactGraph.h"
+#include <algorithm>
+
+CompactGraph::CompactGraph()
+    : m_nodeCount{ 0 }, m_oriented{ true }, m_maxWeight{ 0 }
+    , m_outOffsets{ 0 }, m_outTargets{}, m_outWeights{}, m_outEdges{}
+    , m_inOffsets{ 0 }, m_inSources{}, m_inWeights{}, m_inEdges{}
+{}
+
+void CompactGraph::build(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented)
+{
+    m_nodeCount = nodeCount;
+    m_oriented = oriented;
+    m_maxWeight = 0;
+    m_outOffsets.assign(nodeCount + 1, 0);
+    m_inOffsets.assign(nodeCount + 1, 0);
+
+    for (const auto& edge : edges)
+    {
+        unsigned int startNodeID = edge.getStartNode()->getInternalID();
+        unsigned int endNodeID = edge.getEndNode()->getInternalID();
+
+        ++m_outOffsets[startNodeID + 1];
+        ++m_inOffsets[endNodeID + 1];
+        if (!oriented)
+        {
+            ++m_outOffsets[endNodeID + 1];
+            ++m_inOffsets[startNodeID + 1];
+        }
+    }
+
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        m_outOffsets[nodeID + 1] += m_outOffsets[nodeID];
+        m_inOffsets[nodeID + 1] += m_inOffsets[nodeID];
+    }
+
+    m_outTargets.resize(m_outOffsets[nodeCount]);
+    m_outWeights.resize(m_outOffsets[nodeCount]);
+    m_outEdges.resize(m_outOffsets[nodeCount]);
+    m_inSources.resize(m_inOffsets[nodeCount]);
+    m_inWeights.resize(m_inOffsets[nodeCount]);
+    m_inEdges.resize(m_inOffsets[nodeCount]);
+
+    std::vector<unsigned int> outCursor(m_outOffsets.begin(), m_outOffsets.end() - 1);
+    std::vector<unsigned int> inCursor(m_inOffsets.begin(), m_inOffsets.end() - 1);
+
+    auto addArc = [&](unsigned int startNodeID, unsigned int endNodeID, unsigned int weight, unsigned int edgeIndex)
+    {
+        unsigned int outArc = outCursor[startNodeID]++;
+        m_outTargets[outArc] = endNodeID;
+        m_outWeights[outArc] = weight;
+        m_outEdges[outArc] = edgeIndex;
+
+        unsigned int inArc = inCursor[endNodeID]++;
+        m_inSources[inArc] = startNodeID;
+        m_inWeights[inArc] = weight;
+        m_inEdges[inArc] = edgeIndex;
+    };
+
+    for (unsigned int edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex)
+    {
+        const Edge& edge = edges[edgeIndex];
+        unsigned int startNodeID = edge.getStartNode()->getInternalID();
+        unsigned int endNodeID = edge.getEndNode()->getInternalID();
+        unsigned int weight = static_cast<unsigned int>(std::max(0, edge.getWeight()));
+        m_maxWeight = std::max(m_maxWeight, weight);
+
+        addArc(startNodeID, endNodeID, weight, edgeIndex);
+        if (!oriented)
+        {
+            addArc(endNodeID, startNodeID, weight, edgeIndex);
+        }
+    }
+}
+
+void CompactGraph::clear()
+{
+    m_nodeCount = 0;
+    m_maxWeight = 0;
+    m_outOffsets.assign(1, 0);
+    m_inOffsets.assign(1, 0);
+    m_outTargets.clear();
+    m_outWeights.clear();
+    m_outEdges.clear();
+    m_inSources.clear();
+    m_inWeights.clear();
+    m_inEdges.clear();
+}
+
+void CompactGraph::setEdgeWeight(unsigned int edgeIndex, unsigned int startNodeID, unsigned int endNodeID, unsigned int weight)
+{
+    raiseMaxWeight(weight);
+    setArcWeights(edgeIndex, startNodeID, endNodeID, weight);
+}
+
+void CompactGraph::setArcWeights(unsigned int edgeIndex, unsigned int startNodeID, unsigned int endNodeID, unsigned int weight)
+{
+    setArcWeight(m_outOffsets, m_outWeights, m_outEdges, startNodeID, edgeIndex, weight);
+    setArcWeight(m_inOffsets, m_inWeights, m_inEdges, endNodeID, edgeIndex, weight);
+    if (!m_oriented)
+    {
+        setArcWeight(m_outOffsets, m_outWeights, m_outEdges, endNodeID, edgeIndex, weight);
+        setArcWeight(m_inOffsets, m_inWeights, m_inEdges, startNodeID, edgeIndex, weight);
+    }
+}
+
+void CompactGraph::raiseMaxWeight(unsigned int weight)
+{
+    m_maxWeight = std::max(m_maxWeight, weight);
+}
+
+void CompactGraph::setArcWeight(std::vector<unsigned int>& offsets, std::vector<unsigned int>& weights, const std::vector<unsigned int>& edgeIndices
+                               , unsigned int nodeID, unsigned int edgeIndex, unsigned int weight)
+{
+    for (unsigned int arc = offsets[nodeID]; arc < offsets[nodeID + 1]; ++arc)
+    {
+        if (edgeIndices[arc] == edgeIndex)
+        {
+            weights[arc] = weight;
+        }
+    }
+}
+
+unsigned int CompactGraph::getNodeCount() const
+{
+    return m_nodeCount;
+}
+
+unsigned int CompactGraph::getArcCount() const
+{
+    return static_cast<unsigned int>(m_outTargets.size());
+}
+
+unsigned int CompactGraph::getMaxWeight() const
+{
+    return m_maxWeight;
+}
+
+bool CompactGraph::isOriented() const
+{
+    return m_oriented;
+}
+
+// FNV-1a over the forward arrays, used to check that preprocessed data on disk belongs to this graph.
+unsigned long long CompactGraph::getFingerprint() const
+{
+    unsigned long long hash = 14695981039346656037ull;
+    auto mix = [&hash](const std::vector<unsigned int>& values)
+    {
+        for (unsigned int value : values)
+        {
+            hash = (hash ^ value) * 1099511628211ull;
+        }
+    };
+
+    mix(m_outOffsets);
+    mix(m_outTargets);
+    mix(m_outWeights);
+    return hash;
+}
+
+unsigned long long CompactGraph::getMemoryUsage() const
+{
+    unsigned long long usage = 0;
+    for (const auto* values : { &m_outOffsets, &m_outTargets, &m_outWeights, &m_outEdges, &m_inOffsets, &m_inSources, &m_inWeights, &m_inEdges })
+    {
+        usage += values->size() * sizeof(unsigned int);
+    }
+    return usage;
+}
+
+std::span<const unsigned int> CompactGraph::getOutNeighbors(unsigned int nodeID) const
+{
+    return { m_outTargets.data() + m_outOffsets[nodeID], m_outTargets.data() + m_outOffsets[nodeID + 1] };
+}
+
+std::span<const unsigned int> CompactGraph::getOutWeights(unsigned int nodeID) const
+{
+    return { m_outWeights.data() + m_outOffsets[nodeID], m_outWeights.data() + m_outOffsets[nodeID + 1] };
+}
+
+std::span<const unsigned int> CompactGraph::getOutEdges(unsigned int nodeID) const
+{
+    return { m_outEdges.data() + m_outOffsets[nodeID], m_outEdges.data() + m_outOffsets[nodeID + 1] };
+}
+
+std::span<const unsigned int> CompactGraph::getInNeighbors(unsigned int nodeID) const
+{
+    return { m_inSources.data() + m_inOffsets[nodeID], m_inSources.data() + m_inOffsets[nodeID + 1] };
+}
+
+std::span<const unsigned int> CompactGraph::getInWeights(unsigned int nodeID) const
+{
+    return { m_inWeights.data() + m_inOffsets[nodeID], m_inWeights.data() + m_inOffsets[nodeID + 1] };
+}
+
+std::span<const unsigned int> CompactGraph::getInEdges(unsigned int nodeID) const
+{
+    return { m_inEdges.data() + m_inOffsets[nodeID], m_inEdges.data() + m_inOffsets[nodeID + 1] };
+}
@@ -0,0 +1,85 @@
+#include "ConcurrentUnionFind.h"
+#include "Parallel.h"
+
+ConcurrentUnionFind::ConcurrentUnionFind(unsigned int size)
+    : m_parents(size)
+{
+    for (unsigned int element = 0; element < size; ++element)
+    {
+        m_parents[element].store(element, std::memory_order_relaxed);
+    }
+}
+
+unsigned int ConcurrentUnionFind::find(unsigned int element)
+{
+    unsigned int parent = m_parents[element].load(std::memory_order_relaxed);
+    while (parent != element)
+    {
+        unsigned int grandParent = m_parents[parent].load(std::memory_order_relaxed);
+        m_parents[element].compare_exchange_weak(parent, grandParent, std::memory_order_relaxed);
+        element = parent;
+        parent = m_parents[element].load(std::memory_order_relaxed);
+    }
+    return element;
+}
+
+// Lock-free linking: roots only ever get hooked under a smaller ID, so concurrent links can't form cycles.
+void ConcurrentUnionFind::unite(unsigned int first, unsigned int second)
+{
+    unsigned int firstParent = m_parents[first].load(std::memory_order_relaxed);
+    unsigned int secondParent = m_parents[second].load(std::memory_order_relaxed);
+
+    while (firstParent != secondParent)
+    {
+        unsigned int high = std::max(firstParent, secondParent);
+        unsigned int low = std::min(firstParent, secondParent);
+        unsigned int highParent = m_parents[high].load(std::memory_order_relaxed);
+
+        if (highParent == low)
+        {
+            break;
+        }
+        if (highParent == high && m_parents[high].compare_exchange_strong(highParent, low, std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        firstParent = m_parents[m_parents[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+        secondParent = m_parents[low].load(std::memory_order_relaxed);
+    }
+}
+
+void ConcurrentUnionFind::compress()
+{
+    parallelFor(0, getSize(), [this](unsigned int element)
+    {
+        unsigned int parent = m_parents[element].load(std::memory_order_relaxed);
+        unsigned int grandParent = m_parents[parent].load(std::memory_order_relaxed);
+        while (parent != grandParent)
+        {
+            m_parents[element].store(grandParent, std::memory_order_relaxed);
+            parent = grandParent;
+            grandParent = m_parents[parent].load(std::memory_order_relaxed);
+        }
+    });
+}
+
+unsigned int ConcurrentUnionFind::getSize() const
+{
+    return static_cast<unsigned int>(m_parents.size());
+}
+
+unsigned int ConcurrentUnionFind::getParent(unsigned int element) const
+{
+    return m_parents[element].load(std::memory_order_relaxed);
+}
+
+std::vector<unsigned int> ConcurrentUnionFind::getLabels() const
+{
+    std::vector<unsigned int> labels(m_parents.size());
+    for (unsigned int element = 0; element < m_parents.size(); ++element)
+    {
+        labels[element] = m_parents[element].load(std::memory_order_relaxed);
+    }
+    return labels;
+}
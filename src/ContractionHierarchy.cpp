@@ -0,0 +1,798 @@
+#include "ContractionHierarchy.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <tuple>
+
+static constexpr unsigned int kHierarchyFileMagic = 0x31304843; // "CH01"
+static constexpr unsigned int kWitnessSettleLimit = 500;
+
+namespace
+{
+    struct Neighbor
+    {
+        unsigned int nodeID;
+        unsigned int weight;
+        unsigned int arcID;
+    };
+
+    struct Shortcut
+    {
+        unsigned int startNodeID;
+        unsigned int endNodeID;
+        unsigned int weight;
+        unsigned int firstChild;
+        unsigned int secondChild;
+    };
+
+    using AdjacencyLists = std::vector<std::vector<Neighbor>>;
+
+    // Bounded Dijkstra looking for paths that make a shortcut over the contracted node unnecessary.
+    class WitnessSearch
+    {
+    public:
+        void reset(unsigned int nodeCount)
+        {
+            m_epoch = 0;
+            m_epochs.assign(nodeCount, 0);
+            m_distances.resize(nodeCount);
+            m_queue.reset(nodeCount, 0);
+        }
+
+        // Returns how many shortcuts contracting nodeID needs and appends them when shortcuts isn't null.
+        unsigned int contract(const AdjacencyLists& outNeighbors, const AdjacencyLists& inNeighbors, const std::vector<char>& excluded
+                             , unsigned int nodeID, std::vector<Shortcut>* shortcuts)
+        {
+            unsigned int shortcutCount = 0;
+            for (const Neighbor& inArc : inNeighbors[nodeID])
+            {
+                unsigned int maxOutWeight = 0;
+                bool hasTarget = false;
+                for (const Neighbor& outArc : outNeighbors[nodeID])
+                {
+                    if (outArc.nodeID != inArc.nodeID)
+                    {
+                        maxOutWeight = std::max(maxOutWeight, outArc.weight);
+                        hasTarget = true;
+                    }
+                }
+                if (!hasTarget)
+                {
+                    continue;
+                }
+
+                search(outNeighbors, excluded, inArc.nodeID, nodeID, inArc.weight + maxOutWeight);
+
+                for (const Neighbor& outArc : outNeighbors[nodeID])
+                {
+                    if (outArc.nodeID == inArc.nodeID)
+                    {
+                        continue;
+                    }
+
+                    unsigned int viaDistance = inArc.weight + outArc.weight;
+                    if (!isLabeled(outArc.nodeID) || m_distances[outArc.nodeID] > viaDistance)
+                    {
+                        ++shortcutCount;
+                        if (shortcuts)
+                        {
+                            shortcuts->push_back({ inArc.nodeID, outArc.nodeID, viaDistance, inArc.arcID, outArc.arcID });
+                        }
+                    }
+                }
+            }
+            return shortcutCount;
+        }
+
+    private:
+        void search(const AdjacencyLists& outNeighbors, const std::vector<char>& excluded, unsigned int sourceNodeID
+                   , unsigned int skippedNodeID, unsigned int maxDistance)
+        {
+            if (++m_epoch == 0)
+            {
+                std::fill(m_epochs.begin(), m_epochs.end(), 0);
+                m_epoch = 1;
+            }
+
+            m_queue.reset(static_cast<unsigned int>(m_epochs.size()), 0);
+            m_epochs[sourceNodeID] = m_epoch;
+            m_distances[sourceNodeID] = 0;
+            m_queue.push(sourceNodeID, 0);
+
+            unsigned int settledNodes = 0;
+            while (!m_queue.empty())
+            {
+                auto [currentCost, currentNode] = m_queue.pop();
+                if (currentCost > maxDistance || ++settledNodes > kWitnessSettleLimit)
+                {
+                    break;
+                }
+
+                for (const Neighbor& outArc : outNeighbors[currentNode])
+                {
+                    if (outArc.nodeID == skippedNodeID || excluded[outArc.nodeID])
+                    {
+                        continue;
+                    }
+
+                    unsigned int newCost = currentCost + outArc.weight;
+                    if (!isLabeled(outArc.nodeID) || newCost < m_distances[outArc.nodeID])
+                    {
+                        m_epochs[outArc.nodeID] = m_epoch;
+                        m_distances[outArc.nodeID] = newCost;
+                        m_queue.push(outArc.nodeID, newCost);
+                    }
+                }
+            }
+        }
+
+        bool isLabeled(unsigned int nodeID) const
+        {
+            return m_epochs[nodeID] == m_epoch;
+        }
+
+    private:
+        unsigned int              m_epoch = 0;
+        std::vector<unsigned int> m_epochs;
+        std::vector<unsigned int> m_distances;
+        QuaternaryHeap            m_queue;
+    };
+
+    void removeNeighbor(std::vector<Neighbor>& neighbors, unsigned int nodeID)
+    {
+        neighbors.erase(std::remove_if(neighbors.begin(), neighbors.end(), [nodeID](const Neighbor& neighbor) { return neighbor.nodeID == nodeID; }), neighbors.end());
+    }
+
+    template <typename T>
+    void writeVector(std::ofstream& file, const std::vector<T>& values)
+    {
+        unsigned long long size = values.size();
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    bool readVector(std::ifstream& file, std::vector<T>& values, unsigned long long maxSize)
+    {
+        unsigned long long size = 0;
+        file.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!file || size > maxSize)
+        {
+            return false;
+        }
+
+        // a damaged size must not allocate more than the rest of the file can fill
+        std::streampos position = file.tellg();
+        file.seekg(0, std::ios::end);
+        unsigned long long remainingBytes = static_cast<unsigned long long>(file.tellg() - position);
+        file.seekg(position);
+        if (size > remainingBytes / sizeof(T))
+        {
+            return false;
+        }
+        values.resize(size);
+        file.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+        return static_cast<bool>(file);
+    }
+}
+
+ContractionHierarchy::ContractionHierarchy()
+    : m_nodeCount{ 0 }, m_shortcutCount{ 0 }, m_ranks{}, m_arcs{}
+    , m_upwardOffsets{ 0 }, m_upwardArcs{}, m_downwardOffsets{ 0 }, m_downwardArcs{}
+    , m_epoch{ 0 }, m_searchSpaces{}, m_queues{}
+{}
+
+void ContractionHierarchy::build(const CompactGraph& graph)
+{
+    clear();
+    const unsigned int nodeCount = graph.getNodeCount();
+    m_nodeCount = nodeCount;
+    m_ranks.assign(nodeCount, 0);
+
+    AdjacencyLists outNeighbors(nodeCount), inNeighbors(nodeCount);
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        auto neighbors = graph.getOutNeighbors(nodeID);
+        auto weights = graph.getOutWeights(nodeID);
+        auto edges = graph.getOutEdges(nodeID);
+
+        std::vector<unsigned int> arcs(neighbors.size());
+        for (unsigned int index = 0; index < arcs.size(); ++index)
+        {
+            arcs[index] = index;
+        }
+        std::sort(arcs.begin(), arcs.end(), [&](unsigned int first, unsigned int second)
+        {
+            return std::tie(neighbors[first], weights[first]) < std::tie(neighbors[second], weights[second]);
+        });
+
+        for (unsigned int position = 0; position < arcs.size(); ++position)
+        {
+            unsigned int index = arcs[position];
+            if (neighbors[index] == nodeID || (position > 0 && neighbors[arcs[position - 1]] == neighbors[index]))
+            {
+                continue;
+            }
+
+            unsigned int arcID = static_cast<unsigned int>(m_arcs.size());
+            m_arcs.push_back({ nodeID, neighbors[index], weights[index], edges[index], kNoArc, kNoArc });
+            outNeighbors[nodeID].push_back({ neighbors[index], weights[index], arcID });
+            inNeighbors[neighbors[index]].push_back({ nodeID, weights[index], arcID });
+        }
+    }
+
+    std::vector<WitnessSearch> witnessSearches(getParallelThreadCount());
+    for (WitnessSearch& witnessSearch : witnessSearches)
+    {
+        witnessSearch.reset(nodeCount);
+    }
+
+    std::vector<char> excluded(nodeCount, 0);
+    std::vector<int> priorities(nodeCount, 0);
+    std::vector<int> contractedNeighbors(nodeCount, 0);
+    auto updatePriorities = [&](const std::vector<unsigned int>& nodes)
+    {
+        parallelForChunks(0, static_cast<unsigned int>(nodes.size()), 64, [&](unsigned int threadIndex, unsigned int begin, unsigned int end)
+        {
+            for (unsigned int index = begin; index < end; ++index)
+            {
+                unsigned int nodeID = nodes[index];
+                int shortcutCount = static_cast<int>(witnessSearches[threadIndex].contract(outNeighbors, inNeighbors, excluded, nodeID, nullptr));
+                int removedArcs = static_cast<int>(outNeighbors[nodeID].size() + inNeighbors[nodeID].size());
+                priorities[nodeID] = shortcutCount - removedArcs + contractedNeighbors[nodeID];
+            }
+        });
+    };
+
+    std::vector<unsigned int> remainingNodes(nodeCount);
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        remainingNodes[nodeID] = nodeID;
+    }
+    updatePriorities(remainingNodes);
+
+    std::vector<std::vector<unsigned int>> upwardArcs(nodeCount), downwardArcs(nodeCount);
+    std::vector<char> contracted(nodeCount, 0);
+    std::vector<char> selected(nodeCount, 0);
+    std::vector<char> touched(nodeCount, 0);
+    unsigned int rank = 0;
+
+    while (!remainingNodes.empty())
+    {
+        auto isBefore = [&](unsigned int first, unsigned int second)
+        {
+            return std::tie(priorities[first], first) < std::tie(priorities[second], second);
+        };
+
+        // contract every node that comes before all of its neighbors, those form an independent set
+        parallelFor(0, static_cast<unsigned int>(remainingNodes.size()), [&](unsigned int index)
+        {
+            unsigned int nodeID = remainingNodes[index];
+            bool isMinimum = true;
+            for (const auto* neighbors : { &outNeighbors[nodeID], &inNeighbors[nodeID] })
+            {
+                for (const Neighbor& neighbor : *neighbors)
+                {
+                    isMinimum = isMinimum && isBefore(nodeID, neighbor.nodeID);
+                }
+            }
+            selected[nodeID] = isMinimum;
+        });
+
+        std::vector<unsigned int> contractedNodes;
+        for (unsigned int nodeID : remainingNodes)
+        {
+            if (selected[nodeID])
+            {
+                contractedNodes.push_back(nodeID);
+                excluded[nodeID] = 1;
+            }
+        }
+
+        // witnesses may not pass through nodes contracted in the same round
+        std::vector<std::vector<Shortcut>> shortcuts(contractedNodes.size());
+        parallelForChunks(0, static_cast<unsigned int>(contractedNodes.size()), 16, [&](unsigned int threadIndex, unsigned int begin, unsigned int end)
+        {
+            for (unsigned int index = begin; index < end; ++index)
+            {
+                witnessSearches[threadIndex].contract(outNeighbors, inNeighbors, excluded, contractedNodes[index], &shortcuts[index]);
+            }
+        });
+
+        std::vector<unsigned int> touchedNodes;
+        for (unsigned int index = 0; index < contractedNodes.size(); ++index)
+        {
+            unsigned int nodeID = contractedNodes[index];
+            m_ranks[nodeID] = rank++;
+            contracted[nodeID] = 1;
+            selected[nodeID] = 0;
+
+            for (const Neighbor& outArc : outNeighbors[nodeID])
+            {
+                upwardArcs[nodeID].push_back(outArc.arcID);
+                removeNeighbor(inNeighbors[outArc.nodeID], nodeID);
+                ++contractedNeighbors[outArc.nodeID];
+                if (!touched[outArc.nodeID])
+                {
+                    touched[outArc.nodeID] = 1;
+                    touchedNodes.push_back(outArc.nodeID);
+                }
+            }
+            for (const Neighbor& inArc : inNeighbors[nodeID])
+            {
+                downwardArcs[nodeID].push_back(inArc.arcID);
+                removeNeighbor(outNeighbors[inArc.nodeID], nodeID);
+                ++contractedNeighbors[inArc.nodeID];
+                if (!touched[inArc.nodeID])
+                {
+                    touched[inArc.nodeID] = 1;
+                    touchedNodes.push_back(inArc.nodeID);
+                }
+            }
+            outNeighbors[nodeID].clear();
+            inNeighbors[nodeID].clear();
+
+            for (const Shortcut& shortcut : shortcuts[index])
+            {
+                unsigned int arcID = static_cast<unsigned int>(m_arcs.size());
+                auto existing = std::find_if(outNeighbors[shortcut.startNodeID].begin(), outNeighbors[shortcut.startNodeID].end()
+                                            , [&](const Neighbor& neighbor) { return neighbor.nodeID == shortcut.endNodeID; });
+                if (existing != outNeighbors[shortcut.startNodeID].end())
+                {
+                    if (existing->weight <= shortcut.weight)
+                    {
+                        continue;
+                    }
+                    existing->weight = shortcut.weight;
+                    existing->arcID = arcID;
+                    for (Neighbor& neighbor : inNeighbors[shortcut.endNodeID])
+                    {
+                        if (neighbor.nodeID == shortcut.startNodeID)
+                        {
+                            neighbor.weight = shortcut.weight;
+                            neighbor.arcID = arcID;
+                        }
+                    }
+                }
+                else
+                {
+                    outNeighbors[shortcut.startNodeID].push_back({ shortcut.endNodeID, shortcut.weight, arcID });
+                    inNeighbors[shortcut.endNodeID].push_back({ shortcut.startNodeID, shortcut.weight, arcID });
+                }
+                m_arcs.push_back({ shortcut.startNodeID, shortcut.endNodeID, shortcut.weight, kNoArc, shortcut.firstChild, shortcut.secondChild });
+            }
+        }
+
+        for (unsigned int nodeID : contractedNodes)
+        {
+            excluded[nodeID] = 0;
+        }
+        for (unsigned int nodeID : touchedNodes)
+        {
+            touched[nodeID] = 0;
+        }
+        updatePriorities(touchedNodes);
+
+        remainingNodes.erase(std::remove_if(remainingNodes.begin(), remainingNodes.end(), [&](unsigned int nodeID) { return contracted[nodeID]; }), remainingNodes.end());
+    }
+
+    m_upwardOffsets.assign(nodeCount + 1, 0);
+    m_downwardOffsets.assign(nodeCount + 1, 0);
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        m_upwardOffsets[nodeID + 1] = m_upwardOffsets[nodeID] + static_cast<unsigned int>(upwardArcs[nodeID].size());
+        m_downwardOffsets[nodeID + 1] = m_downwardOffsets[nodeID] + static_cast<unsigned int>(downwardArcs[nodeID].size());
+        m_upwardArcs.insert(m_upwardArcs.end(), upwardArcs[nodeID].begin(), upwardArcs[nodeID].end());
+        m_downwardArcs.insert(m_downwardArcs.end(), downwardArcs[nodeID].begin(), downwardArcs[nodeID].end());
+    }
+
+    for (const auto* arcs : { &m_upwardArcs, &m_downwardArcs })
+    {
+        for (unsigned int arcID : *arcs)
+        {
+            m_shortcutCount += m_arcs[arcID].edgeIndex == kNoArc;
+        }
+    }
+}
+
+void ContractionHierarchy::clear()
+{
+    m_nodeCount = 0;
+    m_shortcutCount = 0;
+    m_ranks.clear();
+    m_arcs.clear();
+    m_upwardOffsets.assign(1, 0);
+    m_upwardArcs.clear();
+    m_downwardOffsets.assign(1, 0);
+    m_downwardArcs.clear();
+}
+
+bool ContractionHierarchy::save(const std::string& filePath, const CompactGraph& graph) const
+{
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Can't open file at: " << filePath << "\n";
+        return false;
+    }
+
+    unsigned long long fingerprint = graph.getFingerprint();
+    file.write(reinterpret_cast<const char*>(&kHierarchyFileMagic), sizeof(kHierarchyFileMagic));
+    file.write(reinterpret_cast<const char*>(&m_nodeCount), sizeof(m_nodeCount));
+    file.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+    writeVector(file, m_ranks);
+    writeVector(file, m_arcs);
+    writeVector(file, m_upwardOffsets);
+    writeVector(file, m_upwardArcs);
+    writeVector(file, m_downwardOffsets);
+    writeVector(file, m_downwardArcs);
+    return static_cast<bool>(file);
+}
+
+bool ContractionHierarchy::load(const std::string& filePath, const CompactGraph& graph)
+{
+    clear();
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    unsigned int magic = 0, nodeCount = 0;
+    unsigned long long fingerprint = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&nodeCount), sizeof(nodeCount));
+    file.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+    if (!file || magic != kHierarchyFileMagic || nodeCount != graph.getNodeCount() || fingerprint != graph.getFingerprint())
+    {
+        std::cout << "Contraction hierarchy at " << filePath << " doesn't match the graph\n";
+        return false;
+    }
+
+    const unsigned long long maxArcs = 1ull << 32;
+    bool complete = readVector(file, m_ranks, nodeCount) && readVector(file, m_arcs, maxArcs)
+                 && readVector(file, m_upwardOffsets, nodeCount + 1ull) && readVector(file, m_upwardArcs, maxArcs)
+                 && readVector(file, m_downwardOffsets, nodeCount + 1ull) && readVector(file, m_downwardArcs, maxArcs);
+    if (!complete || m_upwardOffsets.size() != nodeCount + 1ull || m_downwardOffsets.size() != nodeCount + 1ull)
+    {
+        std::cout << "Contraction hierarchy at " << filePath << " is truncated\n";
+        clear();
+        return false;
+    }
+
+    m_nodeCount = nodeCount;
+    if (!isConsistent(graph))
+    {
+        std::cout << "Contraction hierarchy at " << filePath << " is corrupt\n";
+        clear();
+        return false;
+    }
+
+    for (const auto* arcs : { &m_upwardArcs, &m_downwardArcs })
+    {
+        for (unsigned int arcID : *arcs)
+        {
+            m_shortcutCount += m_arcs[arcID].edgeIndex == kNoArc;
+        }
+    }
+    return true;
+}
+
+// Checks every index a query or an unpack follows, so a damaged file is rejected instead of read out of bounds:
+// ranks form a permutation, offsets delimit the arc lists, upward arcs leave and downward arcs enter their node,
+// original arcs exist in the graph and shortcut halves are older arcs that chain from start to end.
+bool ContractionHierarchy::isConsistent(const CompactGraph& graph) const
+{
+    if (m_ranks.size() != m_nodeCount)
+    {
+        return false;
+    }
+
+    std::vector<char> rankUsed(m_nodeCount, 0);
+    for (unsigned int rank : m_ranks)
+    {
+        if (rank >= m_nodeCount || rankUsed[rank])
+        {
+            return false;
+        }
+        rankUsed[rank] = 1;
+    }
+
+    const unsigned int arcCount = static_cast<unsigned int>(m_arcs.size());
+    for (unsigned int arcID = 0; arcID < arcCount; ++arcID)
+    {
+        const Arc& arc = m_arcs[arcID];
+        if (arc.startNodeID >= m_nodeCount || arc.endNodeID >= m_nodeCount)
+        {
+            return false;
+        }
+
+        if (arc.edgeIndex != kNoArc)
+        {
+            auto neighbors = graph.getOutNeighbors(arc.startNodeID);
+            auto edges = graph.getOutEdges(arc.startNodeID);
+            bool found = false;
+            for (unsigned int index = 0; index < neighbors.size() && !found; ++index)
+            {
+                found = neighbors[index] == arc.endNodeID && edges[index] == arc.edgeIndex;
+            }
+            if (!found)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if (arc.firstChild >= arcID || arc.secondChild >= arcID)
+        {
+            return false;
+        }
+        const Arc& first = m_arcs[arc.firstChild];
+        const Arc& second = m_arcs[arc.secondChild];
+        if (first.startNodeID != arc.startNodeID || first.endNodeID != second.startNodeID || second.endNodeID != arc.endNodeID)
+        {
+            return false;
+        }
+    }
+
+    auto checkArcLists = [&](const std::vector<unsigned int>& offsets, const std::vector<unsigned int>& arcIDs, bool upward)
+    {
+        if (offsets.front() != 0 || offsets.back() != arcIDs.size())
+        {
+            return false;
+        }
+        for (unsigned int nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+        {
+            if (offsets[nodeID] > offsets[nodeID + 1])
+            {
+                return false;
+            }
+            for (unsigned int index = offsets[nodeID]; index < offsets[nodeID + 1]; ++index)
+            {
+                if (arcIDs[index] >= arcCount || (upward ? m_arcs[arcIDs[index]].startNodeID : m_arcs[arcIDs[index]].endNodeID) != nodeID)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+    return checkArcLists(m_upwardOffsets, m_upwardArcs, true) && checkArcLists(m_downwardOffsets, m_downwardArcs, false);
+}
+
+// Both searches only climb in rank. A direction stops once its smallest key can't improve the best meeting,
+// and a node is stalled when a higher neighbor already reaches it more cheaply.
+PathQueryResult ContractionHierarchy::query(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    if (m_searchSpaces[kForward].epochs.size() != m_nodeCount)
+    {
+        for (SearchSpace& searchSpace : m_searchSpaces)
+        {
+            searchSpace.epochs.assign(m_nodeCount, 0);
+            searchSpace.distances.resize(m_nodeCount);
+            searchSpace.parentArcs.resize(m_nodeCount);
+        }
+        m_epoch = 0;
+    }
+    if (++m_epoch == 0)
+    {
+        for (SearchSpace& searchSpace : m_searchSpaces)
+        {
+            std::fill(searchSpace.epochs.begin(), searchSpace.epochs.end(), 0);
+        }
+        m_epoch = 1;
+    }
+
+    auto isLabeled = [this](unsigned int direction, unsigned int nodeID) { return m_searchSpaces[direction].epochs[nodeID] == m_epoch; };
+    auto label = [this](unsigned int direction, unsigned int nodeID, unsigned int distance, unsigned int parentArc)
+    {
+        SearchSpace& searchSpace = m_searchSpaces[direction];
+        searchSpace.epochs[nodeID] = m_epoch;
+        searchSpace.distances[nodeID] = distance;
+        searchSpace.parentArcs[nodeID] = parentArc;
+    };
+
+    label(kForward, sourceNodeID, 0, kNoArc);
+    label(kBackward, targetNodeID, 0, kNoArc);
+    for (unsigned int direction : { kForward, kBackward })
+    {
+        m_queues[direction].reset(m_nodeCount, 0);
+    }
+    m_queues[kForward].push(sourceNodeID, 0);
+    m_queues[kBackward].push(targetNodeID, 0);
+
+    unsigned int bestDistance = PathQueryResult::kUnreachable;
+    unsigned int meetingNodeID = PathQueryResult::kUnreachable;
+    unsigned int settledNodes = 0;
+
+    while (!m_queues[kForward].empty() || !m_queues[kBackward].empty())
+    {
+        for (unsigned int direction : { kForward, kBackward })
+        {
+            QuaternaryHeap& pq = m_queues[direction];
+            if (pq.empty())
+            {
+                continue;
+            }
+
+            auto [currentCost, currentNode] = pq.pop();
+            if (currentCost >= bestDistance)
+            {
+                pq.reset(m_nodeCount, 0);
+                continue;
+            }
+
+            ++settledNodes;
+            const unsigned int otherDirection = direction ^ 1;
+            if (isLabeled(otherDirection, currentNode) && currentCost + m_searchSpaces[otherDirection].distances[currentNode] < bestDistance)
+            {
+                bestDistance = currentCost + m_searchSpaces[otherDirection].distances[currentNode];
+                meetingNodeID = currentNode;
+            }
+
+            auto forwardArcs = direction == kForward ? getUpwardArcs(currentNode) : getDownwardArcs(currentNode);
+            auto stallArcs = direction == kForward ? getDownwardArcs(currentNode) : getUpwardArcs(currentNode);
+
+            bool stalled = false;
+            for (unsigned int arcID : stallArcs)
+            {
+                const Arc& arc = m_arcs[arcID];
+                unsigned int adjNodeID = direction == kForward ? arc.startNodeID : arc.endNodeID;
+                if (isLabeled(direction, adjNodeID) && m_searchSpaces[direction].distances[adjNodeID] + arc.weight < currentCost)
+                {
+                    stalled = true;
+                    break;
+                }
+            }
+            if (stalled)
+            {
+                continue;
+            }
+
+            for (unsigned int arcID : forwardArcs)
+            {
+                const Arc& arc = m_arcs[arcID];
+                unsigned int adjNodeID = direction == kForward ? arc.endNodeID : arc.startNodeID;
+                unsigned int newCost = currentCost + arc.weight;
+
+                if (!isLabeled(direction, adjNodeID) || newCost < m_searchSpaces[direction].distances[adjNodeID])
+                {
+                    label(direction, adjNodeID, newCost, arcID);
+                    pq.push(adjNodeID, newCost);
+                }
+            }
+        }
+    }
+
+    PathQueryResult result;
+    result.settledNodes = settledNodes;
+    if (meetingNodeID == PathQueryResult::kUnreachable)
+    {
+        return result;
+    }
+    result.distance = bestDistance;
+
+    std::vector<unsigned int> arcs;
+    for (unsigned int nodeID = meetingNodeID; nodeID != sourceNodeID; )
+    {
+        unsigned int arcID = m_searchSpaces[kForward].parentArcs[nodeID];
+        arcs.push_back(arcID);
+        nodeID = m_arcs[arcID].startNodeID;
+    }
+    std::reverse(arcs.begin(), arcs.end());
+    for (unsigned int nodeID = meetingNodeID; nodeID != targetNodeID; )
+    {
+        unsigned int arcID = m_searchSpaces[kBackward].parentArcs[nodeID];
+        arcs.push_back(arcID);
+        nodeID = m_arcs[arcID].endNodeID;
+    }
+
+    result.path.push_back(sourceNodeID);
+    for (unsigned int arcID : arcs)
+    {
+        unpackArc(arcID, result.edges, result.path);
+    }
+    return result;
+}
+
+void ContractionHierarchy::computeDistances(unsigned int sourceNodeID, std::vector<unsigned int>& distances) const
+{
+    distances.assign(m_nodeCount, PathQueryResult::kUnreachable);
+    if (sourceNodeID >= m_nodeCount)
+    {
+        return;
+    }
+
+    QuaternaryHeap pq;
+    pq.reset(m_nodeCount, 0);
+    distances[sourceNodeID] = 0;
+    pq.push(sourceNodeID, 0);
+    while (!pq.empty())
+    {
+        auto [currentCost, currentNode] = pq.pop();
+        for (unsigned int arcID : getUpwardArcs(currentNode))
+        {
+            const Arc& arc = m_arcs[arcID];
+            if (currentCost + arc.weight < distances[arc.endNodeID])
+            {
+                distances[arc.endNodeID] = currentCost + arc.weight;
+                pq.push(arc.endNodeID, distances[arc.endNodeID]);
+            }
+        }
+    }
+
+    std::vector<unsigned int> nodesByRank(m_nodeCount);
+    for (unsigned int nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+    {
+        nodesByRank[m_ranks[nodeID]] = nodeID;
+    }
+    for (auto it = nodesByRank.rbegin(); it != nodesByRank.rend(); ++it)
+    {
+        unsigned int& distance = distances[*it];
+        for (unsigned int arcID : getDownwardArcs(*it))
+        {
+            const Arc& arc = m_arcs[arcID];
+            if (distances[arc.startNodeID] != PathQueryResult::kUnreachable && distances[arc.startNodeID] + arc.weight < distance)
+            {
+                distance = distances[arc.startNodeID] + arc.weight;
+            }
+        }
+    }
+}
+
+void ContractionHierarchy::unpackArc(unsigned int arcID, std::vector<unsigned int>& edges, std::vector<unsigned int>& path) const
+{
+    const Arc& arc = m_arcs[arcID];
+    if (arc.edgeIndex != kNoArc)
+    {
+        edges.push_back(arc.edgeIndex);
+        path.push_back(arc.endNodeID);
+        return;
+    }
+
+    unpackArc(arc.firstChild, edges, path);
+    unpackArc(arc.secondChild, edges, path);
+}
+
+bool ContractionHierarchy::isBuilt() const
+{
+    return m_nodeCount > 0 && m_ranks.size() == m_nodeCount;
+}
+
+unsigned int ContractionHierarchy::getNodeCount() const
+{
+    return m_nodeCount;
+}
+
+unsigned int ContractionHierarchy::getRank(unsigned int nodeID) const
+{
+    return m_ranks[nodeID];
+}
+
+unsigned int ContractionHierarchy::getShortcutCount() const
+{
+    return m_shortcutCount;
+}
+
+unsigned long long ContractionHierarchy::getMemoryUsage() const
+{
+    return m_arcs.size() * sizeof(Arc)
+         + (m_ranks.size() + m_upwardOffsets.size() + m_upwardArcs.size() + m_downwardOffsets.size() + m_downwardArcs.size()) * sizeof(unsigned int);
+}
+
+const std::vector<ContractionHierarchy::Arc>& ContractionHierarchy::getArcs() const
+{
+    return m_arcs;
+}
+
+std::span<const unsigned int> ContractionHierarchy::getUpwardArcs(unsigned int nodeID) const
+{
+    return { m_upwardArcs.data() + m_upwardOffsets[nodeID], m_upwardArcs.data() + m_upwardOffsets[nodeID + 1] };
+}
+
+std::span<const unsigned int> ContractionHierarchy::getDownwardArcs(unsigned int nodeID) const
+{
+    return { m_downwardArcs.data() + m_downwardOffsets[nodeID], m_downwardArcs.data() + m_downwardOffsets[nodeID + 1] };
+}
@@ -0,0 +1,458 @@
+#include "CustomizableHierarchy.h"
+#include "Parallel.h"
+#include <algorithm>
+
+static constexpr unsigned int kNone = 0xFFFFFFFF;
+static constexpr unsigned int kDissectionLeafSize = 32;
+
+CustomizableHierarchy::CustomizableHierarchy()
+    : m_nodeCount{ 0 }, m_ranks{}, m_parents{}
+    , m_upwardOffsets{ 0 }, m_upwardTargets{}, m_arcTails{}, m_downwardOffsets{ 0 }, m_downwardSources{}, m_downwardArcs{}, m_nodesByLevel{}
+    , m_inputArcs{}, m_inputDirections{}, m_weights{}, m_middleNodes{}, m_edges{}, m_distances{}, m_parentArcs{}
+{}
+
+void CustomizableHierarchy::build(const CompactGraph& graph, const std::vector<glm::vec2>& positions)
+{
+    clear();
+    const unsigned int nodeCount = graph.getNodeCount();
+    if (nodeCount == 0 || positions.size() != nodeCount)
+    {
+        return;
+    }
+
+    std::vector<std::vector<unsigned int>> neighbors(nodeCount);
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        for (auto adjacent : { graph.getOutNeighbors(nodeID), graph.getInNeighbors(nodeID) })
+        {
+            for (unsigned int adjNodeID : adjacent)
+            {
+                if (adjNodeID != nodeID)
+                {
+                    neighbors[nodeID].push_back(adjNodeID);
+                }
+            }
+        }
+        std::sort(neighbors[nodeID].begin(), neighbors[nodeID].end());
+        neighbors[nodeID].erase(std::unique(neighbors[nodeID].begin(), neighbors[nodeID].end()), neighbors[nodeID].end());
+    }
+
+    std::vector<unsigned int> nodes(nodeCount), order;
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        nodes[nodeID] = nodeID;
+    }
+    std::vector<unsigned char> sides(nodeCount, 0);
+    order.reserve(nodeCount);
+    dissect(nodes, positions, neighbors, sides, order);
+
+    m_ranks.resize(nodeCount);
+    for (unsigned int rank = 0; rank < nodeCount; ++rank)
+    {
+        m_ranks[order[rank]] = rank;
+    }
+
+    // eliminating a node turns its upper neighbors into a clique, which is recorded by handing them to the lowest one
+    std::vector<std::vector<unsigned int>> upperNeighbors(nodeCount);
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        for (unsigned int adjNodeID : neighbors[nodeID])
+        {
+            if (m_ranks[adjNodeID] > m_ranks[nodeID])
+            {
+                upperNeighbors[nodeID].push_back(adjNodeID);
+            }
+        }
+    }
+
+    m_parents.assign(nodeCount, kNone);
+    for (unsigned int nodeID : order)
+    {
+        auto& upper = upperNeighbors[nodeID];
+        std::sort(upper.begin(), upper.end());
+        upper.erase(std::unique(upper.begin(), upper.end()), upper.end());
+        if (upper.empty())
+        {
+            continue;
+        }
+
+        unsigned int parentNodeID = *std::min_element(upper.begin(), upper.end(), [this](unsigned int first, unsigned int second) { return m_ranks[first] < m_ranks[second]; });
+        m_parents[nodeID] = parentNodeID;
+        for (unsigned int adjNodeID : upper)
+        {
+            if (adjNodeID != parentNodeID)
+            {
+                upperNeighbors[parentNodeID].push_back(adjNodeID);
+            }
+        }
+    }
+
+    m_upwardOffsets.assign(nodeCount + 1, 0);
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        m_upwardOffsets[nodeID + 1] = m_upwardOffsets[nodeID] + static_cast<unsigned int>(upperNeighbors[nodeID].size());
+        m_upwardTargets.insert(m_upwardTargets.end(), upperNeighbors[nodeID].begin(), upperNeighbors[nodeID].end());
+        m_arcTails.insert(m_arcTails.end(), upperNeighbors[nodeID].size(), nodeID);
+    }
+
+    m_downwardOffsets.assign(nodeCount + 1, 0);
+    for (unsigned int targetNodeID : m_upwardTargets)
+    {
+        ++m_downwardOffsets[targetNodeID + 1];
+    }
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        m_downwardOffsets[nodeID + 1] += m_downwardOffsets[nodeID];
+    }
+    m_downwardSources.resize(m_upwardTargets.size());
+    m_downwardArcs.resize(m_upwardTargets.size());
+    std::vector<unsigned int> cursor(m_downwardOffsets.begin(), m_downwardOffsets.end() - 1);
+    for (unsigned int arcID = 0; arcID < m_upwardTargets.size(); ++arcID)
+    {
+        unsigned int position = cursor[m_upwardTargets[arcID]]++;
+        m_downwardSources[position] = m_arcTails[arcID];
+        m_downwardArcs[position] = arcID;
+    }
+
+    std::vector<unsigned int> levels(nodeCount, 0);
+    for (unsigned int nodeID : order)
+    {
+        for (unsigned int position = m_downwardOffsets[nodeID]; position < m_downwardOffsets[nodeID + 1]; ++position)
+        {
+            levels[nodeID] = std::max(levels[nodeID], levels[m_downwardSources[position]] + 1);
+        }
+        if (levels[nodeID] >= m_nodesByLevel.size())
+        {
+            m_nodesByLevel.resize(levels[nodeID] + 1);
+        }
+        m_nodesByLevel[levels[nodeID]].push_back(nodeID);
+    }
+
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        for (unsigned int adjNodeID : graph.getOutNeighbors(nodeID))
+        {
+            if (adjNodeID == nodeID)
+            {
+                m_inputArcs.push_back(kNone);
+                m_inputDirections.push_back(kForward);
+                continue;
+            }
+
+            bool upward = m_ranks[nodeID] < m_ranks[adjNodeID];
+            m_inputArcs.push_back(upward ? findArc(nodeID, adjNodeID) : findArc(adjNodeID, nodeID));
+            m_inputDirections.push_back(upward ? kForward : kBackward);
+        }
+    }
+
+    for (unsigned int direction : { kForward, kBackward })
+    {
+        m_distances[direction].assign(nodeCount, PathQueryResult::kUnreachable);
+        m_parentArcs[direction].assign(nodeCount, kNone);
+    }
+    m_nodeCount = nodeCount;
+
+    customize(graph);
+}
+
+// Every arc takes the best of its input arcs and of its lower triangles. The arcs of a node only depend on the arcs
+// of lower neighbors, which sit on earlier levels, so each level is customized in parallel without sharing writes.
+void CustomizableHierarchy::customize(const CompactGraph& graph)
+{
+    const unsigned int arcCount = static_cast<unsigned int>(m_upwardTargets.size());
+    for (unsigned int direction : { kForward, kBackward })
+    {
+        m_weights[direction].assign(arcCount, PathQueryResult::kUnreachable);
+        m_middleNodes[direction].assign(arcCount, kNone);
+        m_edges[direction].assign(arcCount, kNone);
+    }
+
+    unsigned int inputArc = 0;
+    for (unsigned int nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+    {
+        auto weights = graph.getOutWeights(nodeID);
+        auto edges = graph.getOutEdges(nodeID);
+        for (unsigned int index = 0; index < weights.size(); ++index, ++inputArc)
+        {
+            unsigned int arcID = m_inputArcs[inputArc];
+            unsigned int direction = m_inputDirections[inputArc];
+            if (arcID != kNone && weights[index] < m_weights[direction][arcID])
+            {
+                m_weights[direction][arcID] = weights[index];
+                m_edges[direction][arcID] = edges[index];
+            }
+        }
+    }
+
+    auto& forwardWeights = m_weights[kForward];
+    auto& backwardWeights = m_weights[kBackward];
+    for (const auto& level : m_nodesByLevel)
+    {
+        parallelFor(0, static_cast<unsigned int>(level.size()), [&](unsigned int index)
+        {
+            unsigned int nodeID = level[index];
+            for (unsigned int arcID = m_upwardOffsets[nodeID]; arcID < m_upwardOffsets[nodeID + 1]; ++arcID)
+            {
+                unsigned int upperNodeID = m_upwardTargets[arcID];
+                unsigned int lowerPosition = m_downwardOffsets[nodeID];
+                unsigned int upperPosition = m_downwardOffsets[upperNodeID];
+
+                while (lowerPosition < m_downwardOffsets[nodeID + 1] && upperPosition < m_downwardOffsets[upperNodeID + 1])
+                {
+                    unsigned int lowerSource = m_downwardSources[lowerPosition];
+                    unsigned int upperSource = m_downwardSources[upperPosition];
+                    if (lowerSource < upperSource)
+                    {
+                        ++lowerPosition;
+                        continue;
+                    }
+                    if (upperSource < lowerSource)
+                    {
+                        ++upperPosition;
+                        continue;
+                    }
+
+                    // triangle through lowerSource: (lowerSource, nodeID) and (lowerSource, upperNodeID)
+                    unsigned int toLower = m_downwardArcs[lowerPosition];
+                    unsigned int toUpper = m_downwardArcs[upperPosition];
+                    if (backwardWeights[toLower] != PathQueryResult::kUnreachable && forwardWeights[toUpper] != PathQueryResult::kUnreachable
+                        && backwardWeights[toLower] + forwardWeights[toUpper] < forwardWeights[arcID])
+                    {
+                        forwardWeights[arcID] = backwardWeights[toLower] + forwardWeights[toUpper];
+                        m_middleNodes[kForward][arcID] = lowerSource;
+                    }
+                    if (backwardWeights[toUpper] != PathQueryResult::kUnreachable && forwardWeights[toLower] != PathQueryResult::kUnreachable
+                        && backwardWeights[toUpper] + forwardWeights[toLower] < backwardWeights[arcID])
+                    {
+                        backwardWeights[arcID] = backwardWeights[toUpper] + forwardWeights[toLower];
+                        m_middleNodes[kBackward][arcID] = lowerSource;
+                    }
+                    ++lowerPosition;
+                    ++upperPosition;
+                }
+            }
+        }, 64);
+    }
+}
+
+void CustomizableHierarchy::clear()
+{
+    m_nodeCount = 0;
+    m_ranks.clear();
+    m_parents.clear();
+    m_upwardOffsets.assign(1, 0);
+    m_upwardTargets.clear();
+    m_arcTails.clear();
+    m_downwardOffsets.assign(1, 0);
+    m_downwardSources.clear();
+    m_downwardArcs.clear();
+    m_nodesByLevel.clear();
+    m_inputArcs.clear();
+    m_inputDirections.clear();
+    for (unsigned int direction : { kForward, kBackward })
+    {
+        m_weights[direction].clear();
+        m_middleNodes[direction].clear();
+        m_edges[direction].clear();
+        m_distances[direction].clear();
+        m_parentArcs[direction].clear();
+    }
+}
+
+// The search space of a node is its chain of ancestors in the elimination tree, so both searches just walk that chain.
+PathQueryResult CustomizableHierarchy::query(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    PathQueryResult result;
+    const unsigned int endpoints[2]{ sourceNodeID, targetNodeID };
+
+    for (unsigned int direction : { kForward, kBackward })
+    {
+        auto& distances = m_distances[direction];
+        const auto& weights = m_weights[direction];
+        distances[endpoints[direction]] = 0;
+
+        for (unsigned int nodeID = endpoints[direction]; nodeID != kNone; nodeID = m_parents[nodeID])
+        {
+            ++result.settledNodes;
+            if (distances[nodeID] == PathQueryResult::kUnreachable)
+            {
+                continue;
+            }
+
+            for (unsigned int arcID = m_upwardOffsets[nodeID]; arcID < m_upwardOffsets[nodeID + 1]; ++arcID)
+            {
+                unsigned int upperNodeID = m_upwardTargets[arcID];
+                if (weights[arcID] != PathQueryResult::kUnreachable && distances[nodeID] + weights[arcID] < distances[upperNodeID])
+                {
+                    distances[upperNodeID] = distances[nodeID] + weights[arcID];
+                    m_parentArcs[direction][upperNodeID] = arcID;
+                }
+            }
+        }
+    }
+
+    unsigned int meetingNodeID = kNone;
+    for (unsigned int nodeID = sourceNodeID; nodeID != kNone; nodeID = m_parents[nodeID])
+    {
+        unsigned int forwardDistance = m_distances[kForward][nodeID];
+        unsigned int backwardDistance = m_distances[kBackward][nodeID];
+        if (forwardDistance != PathQueryResult::kUnreachable && backwardDistance != PathQueryResult::kUnreachable
+            && forwardDistance + backwardDistance < result.distance)
+        {
+            result.distance = forwardDistance + backwardDistance;
+            meetingNodeID = nodeID;
+        }
+    }
+
+    if (meetingNodeID != kNone)
+    {
+        std::vector<std::pair<unsigned int, unsigned int>> arcs;
+        for (unsigned int nodeID = meetingNodeID; nodeID != sourceNodeID; nodeID = m_arcTails[m_parentArcs[kForward][nodeID]])
+        {
+            arcs.push_back({ m_parentArcs[kForward][nodeID], kForward });
+        }
+        std::reverse(arcs.begin(), arcs.end());
+        for (unsigned int nodeID = meetingNodeID; nodeID != targetNodeID; nodeID = m_arcTails[m_parentArcs[kBackward][nodeID]])
+        {
+            arcs.push_back({ m_parentArcs[kBackward][nodeID], kBackward });
+        }
+
+        result.path.push_back(sourceNodeID);
+        for (const auto& [arcID, direction] : arcs)
+        {
+            unpackArc(arcID, direction, result.edges, result.path);
+        }
+    }
+
+    for (unsigned int direction : { kForward, kBackward })
+    {
+        for (unsigned int nodeID = endpoints[direction]; nodeID != kNone; nodeID = m_parents[nodeID])
+        {
+            m_distances[direction][nodeID] = PathQueryResult::kUnreachable;
+        }
+    }
+    return result;
+}
+
+bool CustomizableHierarchy::isBuilt() const
+{
+    return m_nodeCount > 0;
+}
+
+unsigned int CustomizableHierarchy::getArcCount() const
+{
+    return static_cast<unsigned int>(m_upwardTargets.size());
+}
+
+unsigned int CustomizableHierarchy::getLevelCount() const
+{
+    return static_cast<unsigned int>(m_nodesByLevel.size());
+}
+
+// Recursive coordinate bisection: split at the median of the wider extent, move the smaller side of the cut into
+// the separator and order the separator after both halves.
+void CustomizableHierarchy::dissect(std::vector<unsigned int>& nodes, const std::vector<glm::vec2>& positions, const std::vector<std::vector<unsigned int>>& neighbors
+                                   , std::vector<unsigned char>& sides, std::vector<unsigned int>& order) const
+{
+    if (nodes.size() <= kDissectionLeafSize)
+    {
+        order.insert(order.end(), nodes.begin(), nodes.end());
+        return;
+    }
+
+    glm::vec2 minimum = positions[nodes.front()];
+    glm::vec2 maximum = positions[nodes.front()];
+    for (unsigned int nodeID : nodes)
+    {
+        minimum = glm::min(minimum, positions[nodeID]);
+        maximum = glm::max(maximum, positions[nodeID]);
+    }
+    const int axis = maximum.x - minimum.x >= maximum.y - minimum.y ? 0 : 1;
+
+    const std::size_t middle = nodes.size() / 2;
+    std::nth_element(nodes.begin(), nodes.begin() + middle, nodes.end(), [&](unsigned int first, unsigned int second)
+    {
+        return positions[first][axis] < positions[second][axis] || (positions[first][axis] == positions[second][axis] && first < second);
+    });
+
+    std::vector<unsigned int> parts[2]{ { nodes.begin(), nodes.begin() + middle }, { nodes.begin() + middle, nodes.end() } };
+    for (unsigned char side : { 0, 1 })
+    {
+        for (unsigned int nodeID : parts[side])
+        {
+            sides[nodeID] = side + 1;
+        }
+    }
+
+    std::vector<unsigned int> boundaries[2];
+    for (unsigned char side : { 0, 1 })
+    {
+        for (unsigned int nodeID : parts[side])
+        {
+            bool onBoundary = std::any_of(neighbors[nodeID].begin(), neighbors[nodeID].end(), [&](unsigned int adjNodeID) { return sides[adjNodeID] == 2 - side; });
+            if (onBoundary)
+            {
+                boundaries[side].push_back(nodeID);
+            }
+        }
+    }
+
+    for (unsigned int nodeID : nodes)
+    {
+        sides[nodeID] = 0;
+    }
+
+    const unsigned char separatorSide = boundaries[0].size() <= boundaries[1].size() ? 0 : 1;
+    std::vector<unsigned int>& separator = boundaries[separatorSide];
+    for (unsigned int nodeID : separator)
+    {
+        sides[nodeID] = 3;
+    }
+    auto& separatedPart = parts[separatorSide];
+    separatedPart.erase(std::remove_if(separatedPart.begin(), separatedPart.end(), [&](unsigned int nodeID) { return sides[nodeID] == 3; }), separatedPart.end());
+    for (unsigned int nodeID : separator)
+    {
+        sides[nodeID] = 0;
+    }
+
+    nodes.clear();
+    nodes.shrink_to_fit();
+    dissect(parts[0], positions, neighbors, sides, order);
+    dissect(parts[1], positions, neighbors, sides, order);
+    order.insert(order.end(), separator.begin(), separator.end());
+}
+
+unsigned int CustomizableHierarchy::findArc(unsigned int lowerNodeID, unsigned int upperNodeID) const
+{
+    auto begin = m_upwardTargets.begin() + m_upwardOffsets[lowerNodeID];
+    auto end = m_upwardTargets.begin() + m_upwardOffsets[lowerNodeID + 1];
+    return static_cast<unsigned int>(std::lower_bound(begin, end, upperNodeID) - m_upwardTargets.begin());
+}
+
+// A shortcut over middle node m goes lower -> m -> upper (forward) or upper -> m -> lower (backward),
+// where both halves are arcs stored at m.
+void CustomizableHierarchy::unpackArc(unsigned int arcID, unsigned int direction, std::vector<unsigned int>& edges, std::vector<unsigned int>& path) const
+{
+    unsigned int middleNodeID = m_middleNodes[direction][arcID];
+    unsigned int lowerNodeID = m_arcTails[arcID];
+    unsigned int upperNodeID = m_upwardTargets[arcID];
+    if (middleNodeID == kNone)
+    {
+        edges.push_back(m_edges[direction][arcID]);
+        path.push_back(direction == kForward ? upperNodeID : lowerNodeID);
+        return;
+    }
+
+    unsigned int toLower = findArc(middleNodeID, lowerNodeID);
+    unsigned int toUpper = findArc(middleNodeID, upperNodeID);
+    if (direction == kForward)
+    {
+        unpackArc(toLower, kBackward, edges, path);
+        unpackArc(toUpper, kForward, edges, path);
+    }
+    else
+    {
+        unpackArc(toUpper, kBackward, edges, path);
+        unpackArc(toLower, kForward, edges, path);
+    }
+}
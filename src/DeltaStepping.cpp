@@ -0,0 +1,151 @@
+#include "DeltaStepping.h"
+#include "Parallel.h"
+#include "ShortestPathEngine.h"
+#include <atomic>
+#include <memory>
+
+unsigned int DeltaStepping::suggestBucketWidth(const CompactGraph& graph)
+{
+    if (graph.getNodeCount() == 0)
+    {
+        return 1;
+    }
+    unsigned int averageDegree = std::max(1u, graph.getArcCount() / graph.getNodeCount());
+    return std::max(1u, graph.getMaxWeight() / averageDegree);
+}
+
+void DeltaStepping::computeDistances(const CompactGraph& graph, unsigned int sourceNodeID, unsigned int bucketWidth
+                                    , std::vector<unsigned int>& distances, std::vector<unsigned int>& parentNodes)
+{
+    const unsigned int nodeCount = graph.getNodeCount();
+    distances.assign(nodeCount, PathQueryResult::kUnreachable);
+    parentNodes.assign(nodeCount, PathQueryResult::kUnreachable);
+    if (sourceNodeID >= nodeCount)
+    {
+        return;
+    }
+    bucketWidth = std::max(1u, bucketWidth);
+
+    // (distance << 32 | parent) in one atomic so a distance is never paired with a stale parent
+    auto labels = std::make_unique<std::atomic<unsigned long long>[]>(nodeCount);
+    constexpr unsigned long long kNoLabel = ~0ull;
+    parallelFor(0, nodeCount, [&](unsigned int nodeID) { labels[nodeID].store(kNoLabel, std::memory_order_relaxed); });
+    labels[sourceNodeID].store(static_cast<unsigned long long>(PathQueryResult::kUnreachable), std::memory_order_relaxed);
+
+    auto getDistance = [&](unsigned int nodeID)
+    {
+        return static_cast<unsigned int>(labels[nodeID].load(std::memory_order_relaxed) >> 32);
+    };
+    auto relax = [&](unsigned int nodeID, unsigned int distance, unsigned int parentNodeID)
+    {
+        unsigned long long label = (static_cast<unsigned long long>(distance) << 32) | parentNodeID;
+        unsigned long long current = labels[nodeID].load(std::memory_order_relaxed);
+        while ((label >> 32) < (current >> 32))
+        {
+            if (labels[nodeID].compare_exchange_weak(current, label, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // pending distances lie within maxWeight of the current bucket, so a ring of buckets covers all of them
+    const unsigned int ringSize = graph.getMaxWeight() / bucketWidth + 2;
+    std::vector<std::vector<unsigned int>> buckets(ringSize);
+    buckets[0].push_back(sourceNodeID);
+    unsigned int pendingNodes = 1;
+
+    const unsigned int threadCount = getParallelThreadCount();
+    std::vector<std::vector<unsigned int>> requests(threadCount);
+    std::vector<unsigned int> frontierStamps(nodeCount, 0), settledStamps(nodeCount, 0);
+    std::vector<unsigned int> frontier, settled;
+    unsigned int phase = 0;
+
+    auto flushRequests = [&]()
+    {
+        for (auto& buffer : requests)
+        {
+            for (unsigned int nodeID : buffer)
+            {
+                buckets[(getDistance(nodeID) / bucketWidth) % ringSize].push_back(nodeID);
+            }
+            pendingNodes += static_cast<unsigned int>(buffer.size());
+            buffer.clear();
+        }
+    };
+
+    auto relaxArcs = [&](const std::vector<unsigned int>& nodes, bool light)
+    {
+        auto relaxChunk = [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            auto& buffer = requests[threadIndex];
+            for (unsigned int index = chunkBegin; index < chunkEnd; ++index)
+            {
+                unsigned int nodeID = nodes[index];
+                unsigned int distance = getDistance(nodeID);
+                auto neighbors = graph.getOutNeighbors(nodeID);
+                auto weights = graph.getOutWeights(nodeID);
+                for (unsigned int arc = 0; arc < neighbors.size(); ++arc)
+                {
+                    if ((weights[arc] <= bucketWidth) == light && relax(neighbors[arc], distance + weights[arc], nodeID))
+                    {
+                        buffer.push_back(neighbors[arc]);
+                    }
+                }
+            }
+        };
+
+        // most phases of a bucket touch only a handful of nodes, which is cheaper on this thread than waking the pool
+        const unsigned int frontierSize = static_cast<unsigned int>(nodes.size());
+        if (frontierSize < kMinParallelFrontier)
+        {
+            relaxChunk(0, 0, frontierSize);
+        }
+        else
+        {
+            parallelForChunks(0, frontierSize, 64, relaxChunk);
+        }
+        flushRequests();
+    };
+
+    for (unsigned int bucketIndex = 0; pendingNodes > 0; ++bucketIndex)
+    {
+        auto& bucket = buckets[bucketIndex % ringSize];
+        settled.clear();
+
+        while (!bucket.empty())
+        {
+            ++phase;
+            frontier.clear();
+            pendingNodes -= static_cast<unsigned int>(bucket.size());
+            for (unsigned int nodeID : bucket)
+            {
+                if (getDistance(nodeID) / bucketWidth == bucketIndex && frontierStamps[nodeID] != phase)
+                {
+                    frontierStamps[nodeID] = phase;
+                    frontier.push_back(nodeID);
+                    if (settledStamps[nodeID] != bucketIndex + 1)
+                    {
+                        settledStamps[nodeID] = bucketIndex + 1;
+                        settled.push_back(nodeID);
+                    }
+                }
+            }
+            bucket.clear();
+            relaxArcs(frontier, true);
+        }
+
+        relaxArcs(settled, false);
+    }
+
+    parallelFor(0, nodeCount, [&](unsigned int nodeID)
+    {
+        unsigned long long label = labels[nodeID].load(std::memory_order_relaxed);
+        if (label != kNoLabel)
+        {
+            distances[nodeID] = static_cast<unsigned int>(label >> 32);
+            parentNodes[nodeID] = static_cast<unsigned int>(label);
+        }
+    });
+}
@@ -0,0 +1,220 @@
+#include "DenseGraph.h"
+#include "CpuFeatures.h"
+#include "Parallel.h"
+#include <algorithm>
+
+bool DenseGraph::isWorthwhile(unsigned int nodeCount, float density)
+{
+    return nodeCount > 1 && nodeCount <= kMaxNodeCount && density >= kDensityThreshold;
+}
+
+DenseGraph::DenseGraph()
+    : m_nodeCount{ 0 }, m_stride{ 0 }, m_built{ false }, m_adjacency{}, m_weights{}
+{}
+
+void DenseGraph::build(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented)
+{
+    m_nodeCount = nodeCount;
+    m_stride = (nodeCount + kWeightsPerVector - 1) / kWeightsPerVector * kWeightsPerVector;
+    m_adjacency.resize(nodeCount);
+    m_weights.assign(static_cast<std::size_t>(m_stride) * nodeCount, kNoEdge);
+
+    for (const Edge& edge : edges)
+    {
+        unsigned int startNodeID = edge.getStartNode()->getInternalID();
+        unsigned int endNodeID = edge.getEndNode()->getInternalID();
+        m_adjacency.set(startNodeID, endNodeID);
+        int& weight = m_weights[static_cast<std::size_t>(startNodeID) * m_stride + endNodeID];
+        weight = std::min(weight, edge.getWeight());
+        if (!oriented)
+        {
+            m_adjacency.set(endNodeID, startNodeID);
+            int& reverseWeight = m_weights[static_cast<std::size_t>(endNodeID) * m_stride + startNodeID];
+            reverseWeight = std::min(reverseWeight, edge.getWeight());
+        }
+    }
+    m_built = true;
+}
+
+void DenseGraph::clear()
+{
+    m_nodeCount = 0;
+    m_stride = 0;
+    m_built = false;
+    m_adjacency.resize(0);
+    m_weights.clear();
+}
+
+bool DenseGraph::isBuilt() const
+{
+    return m_built;
+}
+
+bool DenseGraph::hasEdge(unsigned int startNodeID, unsigned int endNodeID) const
+{
+    return m_adjacency.test(startNodeID, endNodeID);
+}
+
+int DenseGraph::getWeight(unsigned int startNodeID, unsigned int endNodeID) const
+{
+    return m_weights[static_cast<std::size_t>(startNodeID) * m_stride + endNodeID];
+}
+
+const BitMatrix& DenseGraph::getAdjacency() const
+{
+    return m_adjacency;
+}
+
+// Pivots are taken 64 at a time: the pivot rows are closed over the block first, then every other row applies the
+// block's pivots in order in parallel. A pivot row already closed over later pivots only adds true paths, and every
+// path the textbook order finds is still found.
+BitMatrix DenseGraph::transitiveClosure() const
+{
+    BitMatrix closure = m_adjacency;
+    const unsigned int wordCount = closure.getWordsPerRow();
+
+    for (unsigned int blockBegin = 0; blockBegin < m_nodeCount; blockBegin += kPivotBlockSize)
+    {
+        const unsigned int blockEnd = std::min(m_nodeCount, blockBegin + kPivotBlockSize);
+        for (unsigned int pivot = blockBegin; pivot < blockEnd; ++pivot)
+        {
+            for (unsigned int row = blockBegin; row < blockEnd; ++row)
+            {
+                if (closure.test(row, pivot))
+                {
+                    orRow(closure.getRow(row), closure.getRow(pivot), wordCount);
+                }
+            }
+        }
+
+        parallelFor(0, m_nodeCount, [&](unsigned int row)
+        {
+            if (row >= blockBegin && row < blockEnd)
+            {
+                return;
+            }
+            for (unsigned int pivot = blockBegin; pivot < blockEnd; ++pivot)
+            {
+                if (closure.test(row, pivot))
+                {
+                    orRow(closure.getRow(row), closure.getRow(pivot), wordCount);
+                }
+            }
+        }, 64);
+    }
+
+    return closure;
+}
+
+std::vector<std::pair<int, int>> DenseGraph::primMST() const
+{
+    std::vector<std::pair<int, int>> resultingEdges;
+    if (m_nodeCount == 0)
+    {
+        return resultingEdges;
+    }
+
+    // padding columns count as tree nodes so they are never picked
+    std::vector<int> minimumCostToReach(m_stride, kNoEdge);
+    std::vector<int> lastNode(m_stride, 0);
+    std::vector<int> inTree(m_stride, 0);
+    std::fill(inTree.begin() + m_nodeCount, inTree.end(), -1);
+
+    unsigned int nodeID = 0;
+    while (true)
+    {
+        inTree[nodeID] = -1;
+        minimumCostToReach[nodeID] = kNoEdge;
+
+        const int* weights = m_weights.data() + static_cast<std::size_t>(nodeID) * m_stride;
+        int minimumCost = relaxPrimRow(weights, static_cast<int>(nodeID), minimumCostToReach.data(), lastNode.data(), inTree.data(), m_stride);
+        if (minimumCost == kNoEdge)
+        {
+            break;
+        }
+
+        nodeID = static_cast<unsigned int>(std::find(minimumCostToReach.begin(), minimumCostToReach.end(), minimumCost) - minimumCostToReach.begin());
+        resultingEdges.push_back({ static_cast<int>(nodeID), lastNode[nodeID] });
+    }
+
+    return resultingEdges;
+}
+
+void DenseGraph::orRow(std::uint64_t* row, const std::uint64_t* pivotRow, unsigned int wordCount)
+{
+#if defined(HAS_AVX2_KERNELS)
+    if (isAvx2Supported())
+    {
+        orRowAvx2(row, pivotRow, wordCount);
+        return;
+    }
+#endif
+    orRowScalar(row, pivotRow, wordCount);
+}
+
+void DenseGraph::orRowScalar(std::uint64_t* row, const std::uint64_t* pivotRow, unsigned int wordCount)
+{
+    for (unsigned int word = 0; word < wordCount; ++word)
+    {
+        row[word] |= pivotRow[word];
+    }
+}
+
+int DenseGraph::relaxPrimRow(const int* weights, int parent, int* minimumCostToReach, int* lastNode, const int* inTree, unsigned int stride)
+{
+#if defined(HAS_AVX2_KERNELS)
+    if (isAvx2Supported())
+    {
+        return relaxPrimRowAvx2(weights, parent, minimumCostToReach, lastNode, inTree, stride);
+    }
+#endif
+    return relaxPrimRowScalar(weights, parent, minimumCostToReach, lastNode, inTree, stride);
+}
+
+int DenseGraph::relaxPrimRowScalar(const int* weights, int parent, int* minimumCostToReach, int* lastNode, const int* inTree, unsigned int stride)
+{
+    int minimumCost = kNoEdge;
+    for (unsigned int column = 0; column < stride; ++column)
+    {
+        bool improved = !inTree[column] && weights[column] < minimumCostToReach[column];
+        minimumCostToReach[column] = improved ? weights[column] : minimumCostToReach[column];
+        lastNode[column] = improved ? parent : lastNode[column];
+        minimumCost = std::min(minimumCost, minimumCostToReach[column]);
+    }
+    return minimumCost;
+}
+
+#if defined(HAS_AVX2_KERNELS)
+// Rows are padded to whole vectors, so neither kernel needs a scalar tail
+AVX2_TARGET void DenseGraph::orRowAvx2(std::uint64_t* row, const std::uint64_t* pivotRow, unsigned int wordCount)
+{
+    for (unsigned int word = 0; word < wordCount; word += BitMatrix::kWordsPerVector)
+    {
+        __m256i bits = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + word))
+                                     , _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pivotRow + word)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + word), bits);
+    }
+}
+
+AVX2_TARGET int DenseGraph::relaxPrimRowAvx2(const int* weights, int parent, int* minimumCostToReach, int* lastNode, const int* inTree, unsigned int stride)
+{
+    const __m256i parentNode = _mm256_set1_epi32(parent);
+    __m256i minimum = _mm256_set1_epi32(kNoEdge);
+    for (unsigned int column = 0; column < stride; column += kWeightsPerVector)
+    {
+        __m256i weight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + column));
+        __m256i cost = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(minimumCostToReach + column));
+        __m256i tree = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inTree + column));
+        __m256i improved = _mm256_andnot_si256(tree, _mm256_cmpgt_epi32(cost, weight));
+        cost = _mm256_blendv_epi8(cost, weight, improved);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(minimumCostToReach + column), cost);
+        __m256i last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lastNode + column));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lastNode + column), _mm256_blendv_epi8(last, parentNode, improved));
+        minimum = _mm256_min_epi32(minimum, cost);
+    }
+    minimum = _mm256_min_epi32(minimum, _mm256_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2)));
+    minimum = _mm256_min_epi32(minimum, _mm256_shuffle_epi32(minimum, _MM_SHUFFLE(2, 3, 0, 1)));
+    minimum = _mm256_min_epi32(minimum, _mm256_permute2x128_si256(minimum, minimum, 1));
+    return _mm256_cvtsi256_si32(minimum);
+}
+#endif
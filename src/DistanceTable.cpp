@@ -0,0 +1,269 @@
+#include "DistanceTable.h"
+#include "Parallel.h"
+#include "ShortestPathEngine.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+static constexpr unsigned int kDistanceTableFileMagic = 0x31544D44; // "DMT1"
+
+DistanceTable::DistanceTable()
+    : m_sources{}, m_targets{}, m_distances{}
+{}
+
+void DistanceTable::compute(const CompactGraph& graph, const ContractionHierarchy* hierarchy
+                           , const std::vector<unsigned int>& sourceNodeIDs, const std::vector<unsigned int>& targetNodeIDs)
+{
+    clear();
+    const unsigned int nodeCount = graph.getNodeCount();
+    auto isValid = [nodeCount](unsigned int nodeID) { return nodeID < nodeCount; };
+    if (!std::all_of(sourceNodeIDs.begin(), sourceNodeIDs.end(), isValid) || !std::all_of(targetNodeIDs.begin(), targetNodeIDs.end(), isValid))
+    {
+        std::cout << "Distance table nodes are outside the graph\n";
+        return;
+    }
+
+    m_sources = sourceNodeIDs;
+    m_targets = targetNodeIDs;
+    m_distances.assign(m_sources.size() * m_targets.size(), PathQueryResult::kUnreachable);
+
+    if (hierarchy && hierarchy->isBuilt() && hierarchy->getNodeCount() == nodeCount)
+    {
+        computeWithHierarchy(*hierarchy);
+    }
+    else
+    {
+        computeWithSearches(graph);
+    }
+}
+
+void DistanceTable::clear()
+{
+    m_sources.clear();
+    m_targets.clear();
+    m_distances.clear();
+}
+
+bool DistanceTable::save(const std::string& filePath) const
+{
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Can't open file at: " << filePath << "\n";
+        return false;
+    }
+
+    unsigned int sourceCount = static_cast<unsigned int>(m_sources.size());
+    unsigned int targetCount = static_cast<unsigned int>(m_targets.size());
+    file.write(reinterpret_cast<const char*>(&kDistanceTableFileMagic), sizeof(kDistanceTableFileMagic));
+    file.write(reinterpret_cast<const char*>(&sourceCount), sizeof(sourceCount));
+    file.write(reinterpret_cast<const char*>(&targetCount), sizeof(targetCount));
+    file.write(reinterpret_cast<const char*>(m_sources.data()), m_sources.size() * sizeof(unsigned int));
+    file.write(reinterpret_cast<const char*>(m_targets.data()), m_targets.size() * sizeof(unsigned int));
+    file.write(reinterpret_cast<const char*>(m_distances.data()), m_distances.size() * sizeof(unsigned int));
+    return static_cast<bool>(file);
+}
+
+bool DistanceTable::load(const std::string& filePath)
+{
+    clear();
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    unsigned int magic = 0, sourceCount = 0, targetCount = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&sourceCount), sizeof(sourceCount));
+    file.read(reinterpret_cast<char*>(&targetCount), sizeof(targetCount));
+    if (!file || magic != kDistanceTableFileMagic)
+    {
+        std::cout << "No distance table at " << filePath << "\n";
+        return false;
+    }
+
+    m_sources.resize(sourceCount);
+    m_targets.resize(targetCount);
+    m_distances.resize(static_cast<std::size_t>(sourceCount) * targetCount);
+    file.read(reinterpret_cast<char*>(m_sources.data()), m_sources.size() * sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(m_targets.data()), m_targets.size() * sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(m_distances.data()), m_distances.size() * sizeof(unsigned int));
+    if (!file)
+    {
+        std::cout << "Distance table at " << filePath << " is truncated\n";
+        clear();
+        return false;
+    }
+    return true;
+}
+
+unsigned int DistanceTable::getDistance(unsigned int sourceIndex, unsigned int targetIndex) const
+{
+    return m_distances[static_cast<std::size_t>(sourceIndex) * m_targets.size() + targetIndex];
+}
+
+const std::vector<unsigned int>& DistanceTable::getSources() const
+{
+    return m_sources;
+}
+
+const std::vector<unsigned int>& DistanceTable::getTargets() const
+{
+    return m_targets;
+}
+
+const std::vector<unsigned int>& DistanceTable::getDistances() const
+{
+    return m_distances;
+}
+
+// Upward search with stall-on-demand; the backward search follows downward arcs against their direction.
+// Only unstalled nodes are reported, the others can't lie on a shortest up-down path.
+void DistanceTable::upwardSearch(const ContractionHierarchy& hierarchy, unsigned int nodeID, bool backward, SearchSpace& searchSpace
+                                , std::vector<std::pair<unsigned int, unsigned int>>& settled)
+{
+    const unsigned int nodeCount = hierarchy.getNodeCount();
+    const auto& arcs = hierarchy.getArcs();
+    if (searchSpace.epochs.size() != nodeCount)
+    {
+        searchSpace.epochs.assign(nodeCount, 0);
+        searchSpace.distances.resize(nodeCount);
+        searchSpace.epoch = 0;
+    }
+    if (++searchSpace.epoch == 0)
+    {
+        std::fill(searchSpace.epochs.begin(), searchSpace.epochs.end(), 0);
+        searchSpace.epoch = 1;
+    }
+
+    auto isLabeled = [&](unsigned int labeledNodeID) { return searchSpace.epochs[labeledNodeID] == searchSpace.epoch; };
+
+    settled.clear();
+    searchSpace.queue.reset(nodeCount, 0);
+    searchSpace.epochs[nodeID] = searchSpace.epoch;
+    searchSpace.distances[nodeID] = 0;
+    searchSpace.queue.push(nodeID, 0);
+
+    while (!searchSpace.queue.empty())
+    {
+        auto [currentCost, currentNode] = searchSpace.queue.pop();
+        if (currentCost > searchSpace.distances[currentNode])
+        {
+            continue;
+        }
+
+        auto searchArcs = backward ? hierarchy.getDownwardArcs(currentNode) : hierarchy.getUpwardArcs(currentNode);
+        auto stallArcs = backward ? hierarchy.getUpwardArcs(currentNode) : hierarchy.getDownwardArcs(currentNode);
+
+        bool stalled = false;
+        for (unsigned int arcID : stallArcs)
+        {
+            const auto& arc = arcs[arcID];
+            unsigned int adjNodeID = backward ? arc.endNodeID : arc.startNodeID;
+            if (isLabeled(adjNodeID) && searchSpace.distances[adjNodeID] + arc.weight < currentCost)
+            {
+                stalled = true;
+                break;
+            }
+        }
+        if (stalled)
+        {
+            continue;
+        }
+        settled.push_back({ currentNode, currentCost });
+
+        for (unsigned int arcID : searchArcs)
+        {
+            const auto& arc = arcs[arcID];
+            unsigned int adjNodeID = backward ? arc.startNodeID : arc.endNodeID;
+            unsigned int newCost = currentCost + arc.weight;
+            if (!isLabeled(adjNodeID) || newCost < searchSpace.distances[adjNodeID])
+            {
+                searchSpace.epochs[adjNodeID] = searchSpace.epoch;
+                searchSpace.distances[adjNodeID] = newCost;
+                searchSpace.queue.push(adjNodeID, newCost);
+            }
+        }
+    }
+}
+
+void DistanceTable::computeWithHierarchy(const ContractionHierarchy& hierarchy)
+{
+    const unsigned int nodeCount = hierarchy.getNodeCount();
+    const unsigned int targetCount = static_cast<unsigned int>(m_targets.size());
+    const unsigned int threadCount = getParallelThreadCount();
+    std::vector<SearchSpace> searchSpaces(threadCount);
+    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> settled(threadCount);
+
+    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> targetSpaces(targetCount);
+    parallelForChunks(0, targetCount, 8, [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+    {
+        for (unsigned int targetIndex = chunkBegin; targetIndex < chunkEnd; ++targetIndex)
+        {
+            upwardSearch(hierarchy, m_targets[targetIndex], true, searchSpaces[threadIndex], targetSpaces[targetIndex]);
+        }
+    });
+
+    std::vector<unsigned int> bucketOffsets(nodeCount + 1, 0);
+    for (const auto& targetSpace : targetSpaces)
+    {
+        for (const auto& [nodeID, distance] : targetSpace)
+        {
+            ++bucketOffsets[nodeID + 1];
+        }
+    }
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        bucketOffsets[nodeID + 1] += bucketOffsets[nodeID];
+    }
+    std::vector<BucketEntry> buckets(bucketOffsets.back());
+    std::vector<unsigned int> cursor(bucketOffsets.begin(), bucketOffsets.end() - 1);
+    for (unsigned int targetIndex = 0; targetIndex < targetCount; ++targetIndex)
+    {
+        for (const auto& [nodeID, distance] : targetSpaces[targetIndex])
+        {
+            buckets[cursor[nodeID]++] = { targetIndex, distance };
+        }
+    }
+    targetSpaces.clear();
+
+    parallelForChunks(0, static_cast<unsigned int>(m_sources.size()), 8, [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+    {
+        for (unsigned int sourceIndex = chunkBegin; sourceIndex < chunkEnd; ++sourceIndex)
+        {
+            upwardSearch(hierarchy, m_sources[sourceIndex], false, searchSpaces[threadIndex], settled[threadIndex]);
+
+            unsigned int* row = m_distances.data() + static_cast<std::size_t>(sourceIndex) * targetCount;
+            for (const auto& [nodeID, distance] : settled[threadIndex])
+            {
+                for (unsigned int position = bucketOffsets[nodeID]; position < bucketOffsets[nodeID + 1]; ++position)
+                {
+                    const BucketEntry& entry = buckets[position];
+                    row[entry.targetIndex] = std::min(row[entry.targetIndex], distance + entry.distance);
+                }
+            }
+        }
+    });
+}
+
+void DistanceTable::computeWithSearches(const CompactGraph& graph)
+{
+    const unsigned int targetCount = static_cast<unsigned int>(m_targets.size());
+    std::vector<std::vector<unsigned int>> distances(getParallelThreadCount());
+
+    parallelForChunks(0, static_cast<unsigned int>(m_sources.size()), 1, [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+    {
+        for (unsigned int sourceIndex = chunkBegin; sourceIndex < chunkEnd; ++sourceIndex)
+        {
+            ShortestPathEngine::computeDistances(graph, m_sources[sourceIndex], false, distances[threadIndex]);
+
+            unsigned int* row = m_distances.data() + static_cast<std::size_t>(sourceIndex) * targetCount;
+            for (unsigned int targetIndex = 0; targetIndex < targetCount; ++targetIndex)
+            {
+                row[targetIndex] = distances[threadIndex][m_targets[targetIndex]];
+            }
+        }
+    });
+}
@@ -0,0 +1,244 @@
+#include "DynamicShortestPathTree.h"
+#include <algorithm>
+
+static constexpr unsigned int kNone = PathQueryResult::kUnreachable;
+
+DynamicShortestPathTree::DynamicShortestPathTree()
+    : m_sourceNodeID{ kNone }, m_distances{}, m_parentNodes{}, m_parentEdges{}, m_children{}, m_childPositions{}, m_affected{}, m_queue{}
+{}
+
+void DynamicShortestPathTree::build(const CompactGraph& graph, unsigned int sourceNodeID)
+{
+    clear();
+    const unsigned int nodeCount = graph.getNodeCount();
+    if (sourceNodeID >= nodeCount)
+    {
+        return;
+    }
+
+    m_sourceNodeID = sourceNodeID;
+    m_distances.assign(nodeCount, kNone);
+    m_parentNodes.assign(nodeCount, kNone);
+    m_parentEdges.assign(nodeCount, kNone);
+    m_children.assign(nodeCount, {});
+    m_childPositions.assign(nodeCount, kNone);
+    m_affected.assign(nodeCount, 0);
+    m_distances[sourceNodeID] = 0;
+
+    repairDecrease(graph, sourceNodeID, 0, kNone, kNone);
+}
+
+void DynamicShortestPathTree::clear()
+{
+    m_sourceNodeID = kNone;
+    m_distances.clear();
+    m_parentNodes.clear();
+    m_parentEdges.clear();
+    m_children.clear();
+    m_childPositions.clear();
+    m_affected.clear();
+}
+
+// Increases are repaired before decreases so the decrease checks never read a distance that is about to grow.
+unsigned int DynamicShortestPathTree::updateEdge(const CompactGraph& graph, unsigned int edgeIndex, unsigned int startNodeID, unsigned int endNodeID)
+{
+    if (!isBuilt())
+    {
+        return 0;
+    }
+
+    std::vector<std::pair<unsigned int, unsigned int>> arcs{ { startNodeID, endNodeID } };
+    if (!graph.isOriented())
+    {
+        arcs.push_back({ endNodeID, startNodeID });
+    }
+
+    auto getWeight = [&](unsigned int tailNodeID, unsigned int headNodeID)
+    {
+        auto neighbors = graph.getOutNeighbors(tailNodeID);
+        auto weights = graph.getOutWeights(tailNodeID);
+        auto edges = graph.getOutEdges(tailNodeID);
+        for (unsigned int index = 0; index < edges.size(); ++index)
+        {
+            if (edges[index] == edgeIndex && neighbors[index] == headNodeID)
+            {
+                return weights[index];
+            }
+        }
+        return kNone;
+    };
+
+    unsigned int touchedNodes = 0;
+    for (const auto& [tailNodeID, headNodeID] : arcs)
+    {
+        bool treeArc = m_parentNodes[headNodeID] == tailNodeID && m_parentEdges[headNodeID] == edgeIndex;
+        if (treeArc && getWeight(tailNodeID, headNodeID) > m_distances[headNodeID] - m_distances[tailNodeID])
+        {
+            touchedNodes += repairIncrease(graph, headNodeID);
+        }
+    }
+    for (const auto& [tailNodeID, headNodeID] : arcs)
+    {
+        unsigned int weight = getWeight(tailNodeID, headNodeID);
+        if (weight != kNone && m_distances[tailNodeID] != kNone && m_distances[tailNodeID] + weight < m_distances[headNodeID])
+        {
+            touchedNodes += repairDecrease(graph, headNodeID, m_distances[tailNodeID] + weight, tailNodeID, edgeIndex);
+        }
+    }
+    return touchedNodes;
+}
+
+bool DynamicShortestPathTree::isBuilt() const
+{
+    return m_sourceNodeID != kNone;
+}
+
+unsigned int DynamicShortestPathTree::getSource() const
+{
+    return m_sourceNodeID;
+}
+
+unsigned int DynamicShortestPathTree::getDistance(unsigned int nodeID) const
+{
+    return m_distances[nodeID];
+}
+
+PathQueryResult DynamicShortestPathTree::getPath(unsigned int targetNodeID) const
+{
+    PathQueryResult result;
+    if (!isBuilt() || targetNodeID >= m_distances.size() || m_distances[targetNodeID] == kNone)
+    {
+        return result;
+    }
+
+    result.distance = m_distances[targetNodeID];
+    for (unsigned int nodeID = targetNodeID; nodeID != m_sourceNodeID; nodeID = m_parentNodes[nodeID])
+    {
+        result.path.push_back(nodeID);
+        result.edges.push_back(m_parentEdges[nodeID]);
+    }
+    result.path.push_back(m_sourceNodeID);
+    std::reverse(result.path.begin(), result.path.end());
+    std::reverse(result.edges.begin(), result.edges.end());
+    return result;
+}
+
+void DynamicShortestPathTree::setParent(unsigned int nodeID, unsigned int parentNodeID, unsigned int parentEdge)
+{
+    unsigned int oldParentNodeID = m_parentNodes[nodeID];
+    if (oldParentNodeID != kNone)
+    {
+        auto& siblings = m_children[oldParentNodeID];
+        unsigned int position = m_childPositions[nodeID];
+        siblings[position] = siblings.back();
+        m_childPositions[siblings[position]] = position;
+        siblings.pop_back();
+    }
+
+    m_parentNodes[nodeID] = parentNodeID;
+    m_parentEdges[nodeID] = parentEdge;
+    m_childPositions[nodeID] = kNone;
+    if (parentNodeID != kNone)
+    {
+        m_childPositions[nodeID] = static_cast<unsigned int>(m_children[parentNodeID].size());
+        m_children[parentNodeID].push_back(nodeID);
+    }
+}
+
+unsigned int DynamicShortestPathTree::repairIncrease(const CompactGraph& graph, unsigned int subtreeRootID)
+{
+    std::vector<unsigned int> subtree{ subtreeRootID };
+    for (unsigned int index = 0; index < subtree.size(); ++index)
+    {
+        const auto& children = m_children[subtree[index]];
+        subtree.insert(subtree.end(), children.begin(), children.end());
+    }
+    for (unsigned int nodeID : subtree)
+    {
+        m_affected[nodeID] = 1;
+        m_distances[nodeID] = kNone;
+        setParent(nodeID, kNone, kNone);
+    }
+
+    // the rest of the tree is still exact, so the best arc entering the subtree from outside seeds every node
+    m_queue.reset(graph.getNodeCount(), graph.getMaxWeight());
+    for (unsigned int nodeID : subtree)
+    {
+        unsigned int bestParentNodeID = kNone, bestParentEdge = kNone;
+        auto neighbors = graph.getInNeighbors(nodeID);
+        auto weights = graph.getInWeights(nodeID);
+        auto edges = graph.getInEdges(nodeID);
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            if (!m_affected[adjNodeID] && m_distances[adjNodeID] != kNone && m_distances[adjNodeID] + weights[index] < m_distances[nodeID])
+            {
+                m_distances[nodeID] = m_distances[adjNodeID] + weights[index];
+                bestParentNodeID = adjNodeID;
+                bestParentEdge = edges[index];
+            }
+        }
+        if (bestParentNodeID != kNone)
+        {
+            setParent(nodeID, bestParentNodeID, bestParentEdge);
+            m_queue.push(nodeID, m_distances[nodeID]);
+        }
+    }
+
+    while (!m_queue.empty())
+    {
+        auto [currentCost, currentNode] = m_queue.pop();
+
+        auto neighbors = graph.getOutNeighbors(currentNode);
+        auto weights = graph.getOutWeights(currentNode);
+        auto edges = graph.getOutEdges(currentNode);
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            unsigned int newCost = currentCost + weights[index];
+            if (m_affected[adjNodeID] && newCost < m_distances[adjNodeID])
+            {
+                m_distances[adjNodeID] = newCost;
+                setParent(adjNodeID, currentNode, edges[index]);
+                m_queue.push(adjNodeID, newCost);
+            }
+        }
+    }
+
+    for (unsigned int nodeID : subtree)
+    {
+        m_affected[nodeID] = 0;
+    }
+    return static_cast<unsigned int>(subtree.size());
+}
+
+unsigned int DynamicShortestPathTree::repairDecrease(const CompactGraph& graph, unsigned int nodeID, unsigned int distance, unsigned int parentNodeID, unsigned int parentEdge)
+{
+    m_queue.reset(graph.getNodeCount(), graph.getMaxWeight());
+    m_distances[nodeID] = distance;
+    setParent(nodeID, parentNodeID, parentEdge);
+    m_queue.push(nodeID, distance);
+
+    unsigned int touchedNodes = 0;
+    while (!m_queue.empty())
+    {
+        auto [currentCost, currentNode] = m_queue.pop();
+        ++touchedNodes;
+
+        auto neighbors = graph.getOutNeighbors(currentNode);
+        auto weights = graph.getOutWeights(currentNode);
+        auto edges = graph.getOutEdges(currentNode);
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            unsigned int newCost = currentCost + weights[index];
+            if (newCost < m_distances[adjNodeID])
+            {
+                m_distances[adjNodeID] = newCost;
+                setParent(adjNodeID, currentNode, edges[index]);
+                m_queue.push(adjNodeID, newCost);
+            }
+        }
+    }
+    return touchedNodes;
+}
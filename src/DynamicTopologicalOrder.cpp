@@ -0,0 +1,235 @@
+#include "DynamicTopologicalOrder.h"
+#include <algorithm>
+#include <stack>
+
+DynamicTopologicalOrder::DynamicTopologicalOrder()
+    : m_acyclic{ true }, m_outNeighbors{}, m_inNeighbors{}, m_positions{}, m_order{}, m_cycle{}
+    , m_visited{}, m_parents{}, m_forwardNodes{}, m_backwardNodes{}
+{}
+
+void DynamicTopologicalOrder::rebuild(const CompactGraph& graph, const std::vector<unsigned int>& order, const std::vector<unsigned int>& cycle)
+{
+    const unsigned int nodeCount = graph.getNodeCount();
+
+    m_outNeighbors.assign(nodeCount, {});
+    m_inNeighbors.assign(nodeCount, {});
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        auto outNeighbors = graph.getOutNeighbors(nodeID);
+        auto inNeighbors = graph.getInNeighbors(nodeID);
+        m_outNeighbors[nodeID].assign(outNeighbors.begin(), outNeighbors.end());
+        m_inNeighbors[nodeID].assign(inNeighbors.begin(), inNeighbors.end());
+    }
+
+    m_visited.assign(nodeCount, false);
+    m_parents.assign(nodeCount, kNone);
+    m_cycle = cycle;
+    m_acyclic = cycle.empty();
+
+    m_order = order;
+    m_positions.assign(nodeCount, 0);
+    for (unsigned int position = 0; position < m_order.size(); ++position)
+    {
+        m_positions[m_order[position]] = position;
+    }
+}
+
+void DynamicTopologicalOrder::clear()
+{
+    m_acyclic = true;
+    m_outNeighbors.clear();
+    m_inNeighbors.clear();
+    m_positions.clear();
+    m_order.clear();
+    m_cycle.clear();
+    m_visited.clear();
+    m_parents.clear();
+}
+
+void DynamicTopologicalOrder::addNode()
+{
+    unsigned int nodeID = static_cast<unsigned int>(m_outNeighbors.size());
+
+    m_outNeighbors.emplace_back();
+    m_inNeighbors.emplace_back();
+    m_visited.push_back(false);
+    m_parents.push_back(kNone);
+    m_positions.push_back(static_cast<unsigned int>(m_order.size()));
+    m_order.push_back(nodeID);
+}
+
+// Pearce-Kelly: only the nodes whose position lies between the two endpoints can be affected, the forward
+// search from the end node and the backward search from the start node never leave that window.
+bool DynamicTopologicalOrder::insertEdge(unsigned int startNodeID, unsigned int endNodeID)
+{
+    m_outNeighbors[startNodeID].push_back(endNodeID);
+    m_inNeighbors[endNodeID].push_back(startNodeID);
+
+    if (!m_acyclic)
+    {
+        return false;
+    }
+
+    if (startNodeID == endNodeID)
+    {
+        m_acyclic = false;
+        m_cycle = { startNodeID, startNodeID };
+        return false;
+    }
+
+    unsigned int lowerBound = m_positions[endNodeID];
+    unsigned int upperBound = m_positions[startNodeID];
+    if (upperBound < lowerBound)
+    {
+        return true;
+    }
+
+    m_forwardNodes.clear();
+    m_backwardNodes.clear();
+
+    bool acyclic = searchForward(endNodeID, upperBound, startNodeID);
+    if (acyclic)
+    {
+        searchBackward(startNodeID, lowerBound);
+        reorder();
+    }
+
+    for (unsigned int nodeID : m_forwardNodes)
+    {
+        m_visited[nodeID] = false;
+        m_parents[nodeID] = kNone;
+    }
+    for (unsigned int nodeID : m_backwardNodes)
+    {
+        m_visited[nodeID] = false;
+    }
+
+    if (!acyclic)
+    {
+        m_acyclic = false;
+    }
+
+    return acyclic;
+}
+
+bool DynamicTopologicalOrder::searchForward(unsigned int startNodeID, unsigned int upperBound, unsigned int targetNodeID)
+{
+    std::stack<unsigned int> toVisit; toVisit.push(startNodeID);
+    m_visited[startNodeID] = true;
+    m_forwardNodes.push_back(startNodeID);
+
+    while (!toVisit.empty())
+    {
+        unsigned int nodeToVisit = toVisit.top();
+        toVisit.pop();
+
+        for (unsigned int adjNodeID : m_outNeighbors[nodeToVisit])
+        {
+            if (adjNodeID == targetNodeID)
+            {
+                recordCycle(targetNodeID, startNodeID, nodeToVisit);
+                return false;
+            }
+
+            if (!m_visited[adjNodeID] && m_positions[adjNodeID] < upperBound)
+            {
+                m_visited[adjNodeID] = true;
+                m_parents[adjNodeID] = nodeToVisit;
+                m_forwardNodes.push_back(adjNodeID);
+                toVisit.push(adjNodeID);
+            }
+        }
+    }
+
+    return true;
+}
+
+void DynamicTopologicalOrder::searchBackward(unsigned int startNodeID, unsigned int lowerBound)
+{
+    std::stack<unsigned int> toVisit; toVisit.push(startNodeID);
+    m_visited[startNodeID] = true;
+    m_backwardNodes.push_back(startNodeID);
+
+    while (!toVisit.empty())
+    {
+        unsigned int nodeToVisit = toVisit.top();
+        toVisit.pop();
+
+        for (unsigned int adjNodeID : m_inNeighbors[nodeToVisit])
+        {
+            if (!m_visited[adjNodeID] && m_positions[adjNodeID] > lowerBound)
+            {
+                m_visited[adjNodeID] = true;
+                m_backwardNodes.push_back(adjNodeID);
+                toVisit.push(adjNodeID);
+            }
+        }
+    }
+}
+
+void DynamicTopologicalOrder::reorder()
+{
+    auto byPosition = [this](unsigned int first, unsigned int second) { return m_positions[first] < m_positions[second]; };
+    std::sort(m_forwardNodes.begin(), m_forwardNodes.end(), byPosition);
+    std::sort(m_backwardNodes.begin(), m_backwardNodes.end(), byPosition);
+
+    std::vector<unsigned int> positions;
+    positions.reserve(m_forwardNodes.size() + m_backwardNodes.size());
+    for (unsigned int nodeID : m_backwardNodes)
+    {
+        positions.push_back(m_positions[nodeID]);
+    }
+    for (unsigned int nodeID : m_forwardNodes)
+    {
+        positions.push_back(m_positions[nodeID]);
+    }
+    std::sort(positions.begin(), positions.end());
+
+    unsigned int index = 0;
+    for (unsigned int nodeID : m_backwardNodes)
+    {
+        m_positions[nodeID] = positions[index];
+        m_order[positions[index++]] = nodeID;
+    }
+    for (unsigned int nodeID : m_forwardNodes)
+    {
+        m_positions[nodeID] = positions[index];
+        m_order[positions[index++]] = nodeID;
+    }
+}
+
+void DynamicTopologicalOrder::recordCycle(unsigned int startNodeID, unsigned int endNodeID, unsigned int lastNodeID)
+{
+    m_cycle.clear();
+    for (unsigned int nodeID = lastNodeID; nodeID != kNone; nodeID = m_parents[nodeID])
+    {
+        m_cycle.push_back(nodeID);
+        if (nodeID == endNodeID)
+        {
+            break;
+        }
+    }
+    m_cycle.push_back(startNodeID);
+    std::reverse(m_cycle.begin(), m_cycle.end());
+    m_cycle.push_back(startNodeID);
+}
+
+bool DynamicTopologicalOrder::isAcyclic() const
+{
+    return m_acyclic;
+}
+
+unsigned int DynamicTopologicalOrder::getPosition(unsigned int nodeID) const
+{
+    return m_positions[nodeID];
+}
+
+const std::vector<unsigned int>& DynamicTopologicalOrder::getOrder() const
+{
+    return m_order;
+}
+
+const std::vector<unsigned int>& DynamicTopologicalOrder::getCycle() const
+{
+    return m_cycle;
+}
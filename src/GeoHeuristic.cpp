@@ -0,0 +1,105 @@
+#include "GeoHeuristic.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#ifdef _DEBUG
+#include <iostream>
+#define LOG(x) std::cout << x << std::endl
+#else
+#define LOG(x) do {} while (0)
+#endif
+
+static constexpr double kEarthRadius = 6371008.8;
+
+double greatCircleDistance(const GeoCoordinate& first, const GeoCoordinate& second)
+{
+    constexpr double toRadians = std::numbers::pi / 180.0;
+    double latitudeDelta = (second.latitude - first.latitude) * toRadians;
+    double longitudeDelta = (second.longitude - first.longitude) * toRadians;
+
+    double a = std::sin(latitudeDelta / 2) * std::sin(latitudeDelta / 2)
+             + std::cos(first.latitude * toRadians) * std::cos(second.latitude * toRadians)
+             * std::sin(longitudeDelta / 2) * std::sin(longitudeDelta / 2);
+    return 2 * kEarthRadius * std::asin(std::min(1.0, std::sqrt(a)));
+}
+
+GeoHeuristic::GeoHeuristic()
+    : m_coordinates{}, m_target{}, m_scale{ 0.0 }, m_calibrated{ false }
+{}
+
+bool GeoHeuristic::calibrate(const CompactGraph& graph, const std::vector<GeoCoordinate>& coordinates)
+{
+    m_calibrated = false;
+    if (coordinates.size() != graph.getNodeCount() || coordinates.empty())
+    {
+        return false;
+    }
+    m_coordinates = coordinates;
+
+    double scale = std::numeric_limits<double>::max();
+    [[maybe_unused]] unsigned int shortestArc = 0;
+    for (unsigned int nodeID = 0; nodeID < graph.getNodeCount(); ++nodeID)
+    {
+        auto neighbors = graph.getOutNeighbors(nodeID);
+        auto weights = graph.getOutWeights(nodeID);
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            double distance = greatCircleDistance(m_coordinates[nodeID], m_coordinates[neighbors[index]]);
+            if (distance > 0.0 && weights[index] / distance < scale)
+            {
+                scale = weights[index] / distance;
+                shortestArc = nodeID;
+            }
+        }
+    }
+
+    if (scale == std::numeric_limits<double>::max())
+    {
+        LOG("No arc joins two distinct positions, A* falls back to bidirectional Dijkstra");
+        return false;
+    }
+    if (scale <= 0.0)
+    {
+        LOG("An arc of length 0 joins two distinct positions (leaving node " << shortestArc << "), A* falls back to bidirectional Dijkstra");
+        return false;
+    }
+
+    // leaves room for rounding so no arc gets an estimate above its length
+    m_scale = scale * (1.0 - 1e-9);
+    m_calibrated = true;
+
+    LOG("A* heuristic: " << m_scale << " length units per meter (tightest arc leaves node " << shortestArc << ")");
+    if (m_scale < 0.5)
+    {
+        LOG("Some arcs are much shorter than the straight line between their ends, A* will prune little");
+    }
+    return true;
+}
+
+void GeoHeuristic::clear()
+{
+    m_coordinates.clear();
+    m_calibrated = false;
+}
+
+void GeoHeuristic::setTarget(unsigned int targetNodeID)
+{
+    m_target = m_coordinates[targetNodeID];
+}
+
+unsigned int GeoHeuristic::estimate(unsigned int nodeID) const
+{
+    return static_cast<unsigned int>(m_scale * greatCircleDistance(m_coordinates[nodeID], m_target));
+}
+
+bool GeoHeuristic::isCalibrated() const
+{
+    return m_calibrated;
+}
+
+double GeoHeuristic::getScale() const
+{
+    return m_scale;
+}
@@ -1,7 +1,10 @@
 ﻿#include "GraphData.h"
+#include "ConcurrentUnionFind.h"
+#include "Parallel.h"
 
 #include <execution>
 #include <queue>
+#include <random>
 #include <set>
 #include <ranges>
 #include <imgui/imgui_internal.h>
@@ -15,8 +18,15 @@
 
 GraphData::GraphData()
     : m_oriented{ true }, m_logAdjacencyMatrix{ false }, m_actions {}, m_nodes{}, m_edges{}
-    , m_adjacencyList{}, m_weighted{ false }, m_edgeWeights{}
-{}
+    , m_adjacencyList{}, m_weighted{ false }, m_edgeWeights{}, m_compactGraph{}, m_compactGraphDirty{ true }, m_version{ 0 }
+    , m_shortestPathEngine{ m_compactGraph }, m_queuePolicyVersion{ std::numeric_limits<unsigned long long>::max() }, m_batchQueryRunner{ m_compactGraph }, m_geoCoordinates{}, m_geoHeuristic{}, m_geoHeuristicDirty{ true }
+    , m_landmarkHeuristic{}, m_contractionHierarchy{}, m_contractionHierarchyStale{ false }, m_hubLabels{}
+    , m_customizableHierarchy{}, m_customizationDirty{ false }, m_shortestPathTree{}, m_reachabilityIndex{}, m_denseGraph{}
+    , m_maintainTopologicalOrder{ false }, m_topologicalOrder{}
+    , m_weakComponents{}, m_inDegree{}, m_outDegree{}, m_sourceNodes{}, m_statistics{}
+{
+    rebuildStatistics();
+}
 
 GraphData::~GraphData()
 {
@@ -30,7 +40,18 @@ void GraphData::addNode(GraphNode* node)
 {
    m_nodes.push_back(node);
    logAdjacencyMatrix("res/adjMatrix/adjMatrix.txt");
-   updateAdjacencyList();
+
+   m_adjacencyList.emplace_back();
+   m_compactGraphDirty = true;
+
+   countNode(node->getInternalID());
+   updateDensity();
+
+   if (isMaintainingTopologicalOrder())
+   {
+       m_topologicalOrder.addNode();
+   }
+
    m_actions.push(Action::newNode);
 }
 
@@ -39,7 +60,25 @@ void GraphData::addEdge(GraphNode* edgeStart, GraphNode* edgeEnd)
    LOG("Edge added");
    m_edges.emplace_back(edgeStart, edgeEnd);
    logAdjacencyMatrix("res/adjMatrix/adjMatrix.txt");
-   updateAdjacencyList();
+
+   unsigned int startNodeID = edgeStart->getInternalID();
+   unsigned int endNodeID = edgeEnd->getInternalID();
+
+   m_adjacencyList[startNodeID].insert(endNodeID);
+   if (!m_oriented)
+   {
+       m_adjacencyList[endNodeID].insert(startNodeID);
+   }
+   m_compactGraphDirty = true;
+
+   countEdge(startNodeID, endNodeID);
+   updateDensity();
+
+   if (isMaintainingTopologicalOrder() && !m_topologicalOrder.insertEdge(startNodeID, endNodeID))
+   {
+       LOG("Edge closes a cycle");
+   }
+
    m_actions.push(Action::newEdge);
 }
 
@@ -53,6 +92,7 @@ void GraphData::setOriented(bool oriented)
 void GraphData::setWeighted(bool weighted)
 {
     m_weighted = weighted;
+    m_statistics.weighted = weighted;
 }
 
 void GraphData::setLogAdjacency(bool log)
@@ -60,6 +100,106 @@ void GraphData::setLogAdjacency(bool log)
     m_logAdjacencyMatrix = log;
 }
 
+void GraphData::setEdgeWeight(Edge& edge, int weight)
+{
+    unsigned int startNodeID = edge.getStartNode()->getInternalID();
+    unsigned int endNodeID = edge.getEndNode()->getInternalID();
+
+    edge.setWeight(weight);
+    invalidateWeights();
+    m_edgeWeights[{ startNodeID, endNodeID }] = weight;
+    if (!m_oriented)
+    {
+        m_edgeWeights[{ endNodeID, startNodeID }] = weight;
+    }
+
+    if (!m_compactGraphDirty)
+    {
+        unsigned int edgeIndex = static_cast<unsigned int>(&edge - m_edges.data());
+        m_compactGraph.setEdgeWeight(edgeIndex, startNodeID, endNodeID, static_cast<unsigned int>(std::max(0, weight)));
+        [[maybe_unused]] unsigned int repairedNodes = m_shortestPathTree.updateEdge(m_compactGraph, edgeIndex, startNodeID, endNodeID);
+        LOG("Repaired " << repairedNodes << " shortest path tree nodes");
+    }
+}
+
+void GraphData::setEdgeWeights(const std::vector<std::pair<unsigned int, int>>& edgeWeights)
+{
+    // the last weight given for an edge wins, so every edge is written by exactly one thread below
+    std::vector<char> seen(m_edges.size(), 0);
+    std::vector<std::pair<unsigned int, int>> batch;
+    batch.reserve(edgeWeights.size());
+    for (auto it = edgeWeights.rbegin(); it != edgeWeights.rend(); ++it)
+    {
+        if (!seen[it->first])
+        {
+            seen[it->first] = 1;
+            batch.push_back(*it);
+        }
+    }
+    if (batch.empty())
+    {
+        return;
+    }
+
+    const bool updateCompactGraph = !m_compactGraphDirty;
+    std::vector<unsigned int> threadMaxWeights(getParallelThreadCount(), 0);
+    parallelForChunks(0, static_cast<unsigned int>(batch.size()), 1024, [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+    {
+        for (unsigned int i = chunkBegin; i < chunkEnd; ++i)
+        {
+            const auto& [edgeIndex, weight] = batch[i];
+            Edge& edge = m_edges[edgeIndex];
+            edge.setWeight(weight);
+            if (updateCompactGraph)
+            {
+                unsigned int arcWeight = static_cast<unsigned int>(std::max(0, weight));
+                m_compactGraph.setArcWeights(edgeIndex, edge.getStartNode()->getInternalID(), edge.getEndNode()->getInternalID(), arcWeight);
+                threadMaxWeights[threadIndex] = std::max(threadMaxWeights[threadIndex], arcWeight);
+            }
+        }
+    });
+
+    for (const auto& [edgeIndex, weight] : batch)
+    {
+        unsigned int startNodeID = m_edges[edgeIndex].getStartNode()->getInternalID();
+        unsigned int endNodeID = m_edges[edgeIndex].getEndNode()->getInternalID();
+        m_edgeWeights[{ startNodeID, endNodeID }] = weight;
+        if (!m_oriented)
+        {
+            m_edgeWeights[{ endNodeID, startNodeID }] = weight;
+        }
+    }
+
+    invalidateWeights();
+    if (updateCompactGraph)
+    {
+        m_compactGraph.raiseMaxWeight(*std::max_element(threadMaxWeights.begin(), threadMaxWeights.end()));
+        // one rebuild is cheaper than repairing the tree once per edge when a batch touches many edges
+        if (m_shortestPathTree.isBuilt())
+        {
+            m_shortestPathTree.build(m_compactGraph, m_shortestPathTree.getSource());
+        }
+    }
+    customizeHierarchy();
+}
+
+void GraphData::invalidateWeights()
+{
+    ++m_version;
+    m_geoHeuristicDirty = true;
+    m_landmarkHeuristic.clear();
+    // the contraction order and shortcuts only hold for the old weights; queries use the customizable hierarchy until a rebuild
+    m_contractionHierarchyStale = true;
+    m_customizationDirty = true;
+    m_denseGraph.clear();
+}
+
+void GraphData::setMaintainTopologicalOrder(bool maintain)
+{
+    m_maintainTopologicalOrder = maintain;
+    rebuildTopologicalOrder();
+}
+
 void GraphData::clear()
 {
    for (const auto& node : m_nodes)
@@ -69,6 +209,8 @@ void GraphData::clear()
    m_nodes.clear();
    m_edges.clear();
    m_edgeWeights.clear();
+   m_geoCoordinates.clear();
+   m_geoHeuristic.clear();
    logAdjacencyMatrix("res/adjMatrix/adjMatrix.txt");
    updateAdjacencyList();
 }
@@ -101,6 +243,43 @@ const std::vector<std::unordered_set<int>>& GraphData::getAdjacencyList() const
     return m_adjacencyList;
 }
 
+const CompactGraph& GraphData::getCompactGraph() const
+{
+    if (m_compactGraphDirty)
+    {
+        m_compactGraph.build(static_cast<unsigned int>(m_nodes.size()), m_edges, m_oriented);
+        m_compactGraphDirty = false;
+        ++m_version;
+        m_geoHeuristicDirty = true;
+        m_landmarkHeuristic.clear();
+        m_contractionHierarchy.clear();
+        m_hubLabels.clear();
+        m_customizableHierarchy.clear();
+        m_shortestPathTree.clear();
+        m_reachabilityIndex.clear();
+        m_denseGraph.clear();
+    }
+    return m_compactGraph;
+}
+
+// Bumped by every CSR rebuild and weight edit, so equal versions mean identical routing results.
+unsigned long long GraphData::getVersion() const
+{
+    getCompactGraph();
+    return m_version;
+}
+
+void GraphData::setGeoCoordinates(std::vector<GeoCoordinate> coordinates)
+{
+    m_geoCoordinates = std::move(coordinates);
+    m_geoHeuristicDirty = true;
+}
+
+const std::vector<GeoCoordinate>& GraphData::getGeoCoordinates() const
+{
+    return m_geoCoordinates;
+}
+
 std::unordered_map<std::pair<int, int>, int, GraphData::PairHash>& GraphData::getEdgeWeights()
 {
     return m_edgeWeights;
@@ -189,6 +368,11 @@ GraphNode* GraphData::getNode(unsigned int nodeID)
 
 Edge* GraphData::getEdge(unsigned int startNodeID, unsigned int endNodeID)
 {
+    if (!hasEdge(startNodeID, endNodeID))
+    {
+        return nullptr;
+    }
+
     for (auto& edge : m_edges)
     {
         if (edge.getStartNode()->getInternalID() == startNodeID && edge.getEndNode()->getInternalID() == endNodeID)
@@ -206,6 +390,16 @@ Edge* GraphData::getEdge(unsigned int startNodeID, unsigned int endNodeID)
 
 bool GraphData::checkCycles() const
 {
+    if (isMaintainingTopologicalOrder())
+    {
+        return !m_topologicalOrder.isAcyclic();
+    }
+
+    if (m_oriented || m_nodes.empty())
+    {
+        return !topologicalLevels().cycle.empty();
+    }
+
     unsigned int startNodeID = m_nodes[std::rand() % m_nodes.size()]->getInternalID();
 
     std::vector<int> parents(m_nodes.size(), -1);
@@ -273,47 +467,43 @@ GraphNode* GraphData::findRoot()
         return nullptr;
     }
 
-    std::vector<unsigned int> inDegree(m_nodes.size(), 0);
-
-    for (const auto& edge : m_edges)
+    // an undirected tree is rooted at the last node no stored edge points to
+    if (!m_oriented)
     {
-        unsigned int endNodeID = edge.getEndNode()->getInternalID();
-        inDegree[endNodeID]++;
+        return this->getNode(*m_sourceNodes.rbegin());
     }
 
-    GraphNode* root = nullptr;
-
-    for (unsigned int nodeID = 0; nodeID < m_nodes.size(); ++nodeID)
-    {
-        if (inDegree[nodeID] == 0)
-        {
-            if (root != nullptr && m_oriented)
-            {
-                std::cout << "More than 1 root candidate\n";
-                return nullptr;
-            }
-            root = this->getNode(nodeID);
-        }
-    }
-
-    if (root == nullptr && m_oriented)
+    if (m_sourceNodes.size() != 1)
     {
         std::cout << "More than 1 root candidate\n";
+        return nullptr;
     }
+    return this->getNode(*m_sourceNodes.begin());
+}
 
-    return root;
+bool GraphData::isTree() const
+{
+    return isWeaklyConnected() && m_edges.size() == m_nodes.size() - 1;
 }
 
-bool GraphData::isTree()
+bool GraphData::isWeaklyConnected() const
 {
-    return (isWeaklyConnected() && !this->checkCycles());
+    return !m_nodes.empty() && m_weakComponents.getComponentCount() == 1;
 }
 
-bool GraphData::isWeaklyConnected()
+unsigned int GraphData::getInDegree(unsigned int nodeID) const
 {
-    std::vector<std::vector<unsigned int>> components = weaklyConnectedComponents(m_nodes[rand() % m_nodes.size()]);
+    return m_inDegree[nodeID];
+}
 
-    return components.size() == 1;
+unsigned int GraphData::getOutDegree(unsigned int nodeID) const
+{
+    return m_outDegree[nodeID];
+}
+
+const GraphData::Statistics& GraphData::getStatistics() const
+{
+    return m_statistics;
 }
 
 void GraphData::reconstructGraphFromComponents(const std::vector<std::vector<unsigned int>>& components)
@@ -432,132 +622,383 @@ std::vector<std::vector<unsigned int>> GraphData::stronglyConnectedComponents(co
     return components;
 }
 
-std::vector<unsigned int> GraphData::dijkstraMinimumCost(const GraphNode* const startNode, const GraphNode* const endNode)
+std::vector<unsigned int> GraphData::dijkstraMinimumCost(const GraphNode* const startNode, const GraphNode* const endNode) const
 {
-    constexpr unsigned int inf = std::numeric_limits<unsigned int>::max();
-    const unsigned int startNodeID = startNode->getInternalID();
-    const unsigned int endNodeID = endNode->getInternalID();
+    return shortestPath(startNode->getInternalID(), endNode->getInternalID()).path;
+}
 
-    using Pair = std::pair<unsigned int, unsigned int>;
-    std::priority_queue<Pair, std::vector<Pair>, std::greater<>> pq;
+PathQueryResult GraphData::shortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    getCompactGraph();
+    return m_shortestPathEngine.query(sourceNodeID, targetNodeID);
+}
 
-    std::vector<unsigned int> costs(m_nodes.size(), inf);
-    std::vector<int> parents(m_nodes.size(), -1);
+PathQueryResult GraphData::bidirectionalShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    getCompactGraph();
+    return m_shortestPathEngine.bidirectionalQuery(sourceNodeID, targetNodeID);
+}
 
-    costs[startNodeID] = 0;
-    pq.emplace(0, startNodeID);
+bool GraphData::hasGeoHeuristic() const
+{
+    const CompactGraph& graph = getCompactGraph();
+    if (m_geoHeuristicDirty)
+    {
+        m_geoHeuristic.calibrate(graph, m_geoCoordinates);
+        m_geoHeuristicDirty = false;
+    }
+    return m_geoHeuristic.isCalibrated();
+}
 
-    while (!pq.empty())
+PathQueryResult GraphData::aStarShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    if (!hasGeoHeuristic())
     {
-        auto [currentCost, currentNode] = pq.top();
-        pq.pop();
+        return m_shortestPathEngine.bidirectionalQuery(sourceNodeID, targetNodeID);
+    }
 
-        if (currentCost > costs[currentNode])
-            continue;
+    m_geoHeuristic.setTarget(targetNodeID);
+    return m_shortestPathEngine.aStarQuery(sourceNodeID, targetNodeID, m_geoHeuristic);
+}
 
-        for (int adjNodeID : m_adjacencyList[currentNode])
-        {
-            unsigned int edgeWeight = m_edgeWeights[{currentNode, adjNodeID}];
-            unsigned int newCost = costs[currentNode] + edgeWeight;
+PathQueryResult GraphData::landmarkShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    if (!hasLandmarks())
+    {
+        return aStarShortestPath(sourceNodeID, targetNodeID);
+    }
 
-            if (newCost < costs[adjNodeID])
-            {
-                costs[adjNodeID] = newCost;
-                parents[adjNodeID] = currentNode;
-                pq.emplace(newCost, adjNodeID);
-            }
+    m_landmarkHeuristic.setTarget(targetNodeID);
+    return m_shortestPathEngine.aStarQuery(sourceNodeID, targetNodeID, m_landmarkHeuristic);
+}
+
+void GraphData::buildLandmarks(unsigned int landmarkCount, LandmarkSelection selection)
+{
+    m_landmarkHeuristic.build(getCompactGraph(), landmarkCount, selection);
+}
+
+bool GraphData::saveLandmarks(const std::string& filePath) const
+{
+    return m_landmarkHeuristic.save(filePath, getCompactGraph());
+}
+
+bool GraphData::loadLandmarks(const std::string& filePath)
+{
+    return m_landmarkHeuristic.load(filePath, getCompactGraph());
+}
+
+bool GraphData::hasLandmarks() const
+{
+    getCompactGraph();
+    return m_landmarkHeuristic.isBuilt();
+}
+
+PathQueryResult GraphData::contractionHierarchyShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    if (!hasContractionHierarchy())
+    {
+        if (hasCustomizableHierarchy())
+        {
+            return customizableShortestPath(sourceNodeID, targetNodeID);
         }
+        return landmarkShortestPath(sourceNodeID, targetNodeID);
     }
+    return m_contractionHierarchy.query(sourceNodeID, targetNodeID);
+}
+
+void GraphData::buildContractionHierarchy()
+{
+    m_contractionHierarchy.build(getCompactGraph());
+    m_contractionHierarchyStale = false;
+    m_hubLabels.clear();
+}
+
+bool GraphData::saveContractionHierarchy(const std::string& filePath) const
+{
+    return m_contractionHierarchy.save(filePath, getCompactGraph());
+}
 
-    std::vector<unsigned int> path;
-    for (unsigned int node = endNodeID; node != static_cast<unsigned int>(-1); node = parents[node])
+bool GraphData::loadContractionHierarchy(const std::string& filePath)
+{
+    m_hubLabels.clear();
+    if (!m_contractionHierarchy.load(filePath, getCompactGraph()))
     {
-        path.push_back(node);
-        if (node == startNodeID) break;
+        return false;
     }
+    m_contractionHierarchyStale = false;
+    return true;
+}
 
-    std::reverse(path.begin(), path.end());
+// A hierarchy contracted before a weight edit is kept but not used
+bool GraphData::hasContractionHierarchy() const
+{
+    getCompactGraph();
+    return m_contractionHierarchy.isBuilt() && !m_contractionHierarchyStale;
+}
 
-    if (path.empty() || path.front() != startNodeID)
-        return {};
+const ContractionHierarchy& GraphData::getContractionHierarchy() const
+{
+    getCompactGraph();
+    return m_contractionHierarchy;
+}
 
-    return path;
+BatchQueryResult GraphData::batchShortestPaths(const std::vector<std::pair<unsigned int, unsigned int>>& queries, bool withPaths) const
+{
+    getCompactGraph();
+    return m_batchQueryRunner.run(queries, withPaths, m_shortestPathEngine.getQueuePolicy());
 }
 
-std::vector<std::vector<unsigned int>> GraphData::weaklyConnectedComponents(const GraphNode* const startNode)
+PathQueryResult GraphData::dynamicShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const
 {
-    bool oriented = m_oriented;
+    const CompactGraph& graph = getCompactGraph();
+    if (!m_shortestPathTree.isBuilt() || m_shortestPathTree.getSource() != sourceNodeID)
+    {
+        m_shortestPathTree.build(graph, sourceNodeID);
+    }
+    return m_shortestPathTree.getPath(targetNodeID);
+}
 
-    if (oriented)
+PathQueryResult GraphData::customizableShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    if (!hasCustomizableHierarchy())
     {
-        this->setOriented(false);
+        return bidirectionalShortestPath(sourceNodeID, targetNodeID);
     }
+    customizeHierarchy();
+    return m_customizableHierarchy.query(sourceNodeID, targetNodeID);
+}
 
-    unsigned int startNodeID = startNode->getInternalID();
-    std::stack<unsigned int> visited; visited.push(startNodeID);
-    std::stack<unsigned int> visitedAndAnalyzed;
+std::vector<PathQueryResult> GraphData::kShortestPaths(unsigned int sourceNodeID, unsigned int targetNodeID, unsigned int pathCount) const
+{
+    return KShortestPaths::compute(getCompactGraph(), sourceNodeID, targetNodeID, pathCount);
+}
 
-    std::unordered_set<unsigned int> unvisited;
-    for (const auto node : m_nodes)
+unsigned int GraphData::hubLabelDistance(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    if (!hasHubLabels())
     {
-        unsigned int nodeID = node->getInternalID();
-        if (nodeID != startNodeID)
-        {
-            unvisited.insert(nodeID);
-        }
+        return contractionHierarchyShortestPath(sourceNodeID, targetNodeID).distance;
     }
+    return m_hubLabels.distance(sourceNodeID, targetNodeID);
+}
 
-    std::vector<std::vector<unsigned int>> components;
-    std::vector<unsigned int> currentComponent;
-    currentComponent.push_back(startNodeID);
+void GraphData::buildHubLabels()
+{
+    if (!hasContractionHierarchy())
+    {
+        buildContractionHierarchy();
+    }
+    m_hubLabels.build(m_contractionHierarchy);
+}
 
-    while (!unvisited.empty() || !visited.empty())
+bool GraphData::hasHubLabels() const
+{
+    return hasContractionHierarchy() && m_hubLabels.isBuilt();
+}
+
+const HubLabels& GraphData::getHubLabels() const
+{
+    getCompactGraph();
+    return m_hubLabels;
+}
+
+void GraphData::buildCustomizableHierarchy()
+{
+    std::vector<glm::vec2> positions;
+    positions.reserve(m_nodes.size());
+    for (const auto& node : m_nodes)
     {
-        while (!visited.empty())
+        positions.push_back(node->getPosition());
+    }
+    m_customizableHierarchy.build(getCompactGraph(), positions);
+    m_customizationDirty = false;
+}
+
+void GraphData::customizeHierarchy() const
+{
+    if (m_customizationDirty && hasCustomizableHierarchy())
+    {
+        m_customizableHierarchy.customize(m_compactGraph);
+    }
+    m_customizationDirty = false;
+}
+
+bool GraphData::hasCustomizableHierarchy() const
+{
+    getCompactGraph();
+    return m_customizableHierarchy.isBuilt();
+}
+
+const CustomizableHierarchy& GraphData::getCustomizableHierarchy() const
+{
+    getCompactGraph();
+    return m_customizableHierarchy;
+}
+
+void GraphData::deltaSteppingDistances(unsigned int sourceNodeID, std::vector<unsigned int>& distances, std::vector<unsigned int>& parentNodes
+                                      , unsigned int bucketWidth) const
+{
+    const CompactGraph& graph = getCompactGraph();
+    if (bucketWidth == 0)
+    {
+        bucketWidth = DeltaStepping::suggestBucketWidth(graph);
+    }
+    DeltaStepping::computeDistances(graph, sourceNodeID, bucketWidth, distances, parentNodes);
+}
+
+DistanceTable GraphData::distanceTable(const std::vector<unsigned int>& sourceNodeIDs, const std::vector<unsigned int>& targetNodeIDs) const
+{
+    DistanceTable table;
+    const CompactGraph& graph = getCompactGraph();
+    table.compute(graph, hasContractionHierarchy() ? &m_contractionHierarchy : nullptr, sourceNodeIDs, targetNodeIDs);
+    return table;
+}
+
+void GraphData::nodesWithinDistance(unsigned int sourceNodeID, unsigned int maxDistance, std::vector<std::pair<unsigned int, unsigned int>>& reachedNodes) const
+{
+    getCompactGraph();
+    m_shortestPathEngine.rangeQuery(sourceNodeID, maxDistance, reachedNodes);
+}
+
+void GraphData::oneToAllDistances(unsigned int sourceNodeID, std::vector<unsigned int>& distances) const
+{
+    if (hasContractionHierarchy())
+    {
+        m_contractionHierarchy.computeDistances(sourceNodeID, distances);
+        return;
+    }
+    ShortestPathEngine::computeDistances(getCompactGraph(), sourceNodeID, false, distances);
+}
+
+AllPairsShortestPaths GraphData::allPairsShortestPaths() const
+{
+    AllPairsShortestPaths allPairs;
+    const unsigned int nodeCount = static_cast<unsigned int>(m_nodes.size());
+    if (AllPairsShortestPaths::prefersFloydWarshall(nodeCount, getCompactGraph().getArcCount()))
+    {
+        allPairs.computeFloydWarshall(nodeCount, m_edges, m_oriented);
+    }
+    else
+    {
+        allPairs.computeJohnson(nodeCount, m_edges, m_oriented);
+    }
+    return allPairs;
+}
+
+bool GraphData::saveAllPairsShortestPaths(const std::string& filePath) const
+{
+    AllPairsShortestPaths allPairs;
+    const unsigned int nodeCount = static_cast<unsigned int>(m_nodes.size());
+    if (AllPairsShortestPaths::prefersFloydWarshall(nodeCount, getCompactGraph().getArcCount()))
+    {
+        return allPairs.computeFloydWarshall(nodeCount, m_edges, m_oriented) && allPairs.save(filePath);
+    }
+    return allPairs.streamJohnson(nodeCount, m_edges, m_oriented, filePath);
+}
+
+// The benchmark is only rerun once the graph has changed since the last one.
+QueuePolicy GraphData::selectFastestQueuePolicy(unsigned int sampleQueries) const
+{
+    getCompactGraph();
+    if (m_queuePolicyVersion != m_version)
+    {
+        m_shortestPathEngine.benchmarkQueuePolicies(sampleQueries);
+        m_queuePolicyVersion = m_version;
+    }
+    return m_shortestPathEngine.getQueuePolicy();
+}
+
+std::vector<std::vector<unsigned int>> GraphData::weaklyConnectedComponents(const GraphNode* const startNode)
+{
+    std::vector<unsigned int> labels = weaklyConnectedComponentLabels();
+    unsigned int startLabel = labels[startNode->getInternalID()];
+
+    std::vector<int> componentIndex(labels.size(), -1);
+    std::vector<std::vector<unsigned int>> components(1);
+    componentIndex[startLabel] = 0;
+
+    for (unsigned int nodeID = 0; nodeID < labels.size(); ++nodeID)
+    {
+        unsigned int label = labels[nodeID];
+        if (componentIndex[label] == -1)
         {
-            unsigned int nodeToVisit = visited.top();
+            componentIndex[label] = static_cast<int>(components.size());
+            components.emplace_back();
+        }
+        components[componentIndex[label]].push_back(nodeID);
+    }
 
-            bool foundAdjNode = false;
+    return components;
+}
 
-            for (unsigned int adjNode : m_adjacencyList[nodeToVisit])
+// Afforest: link a couple of sampled neighbors per node, guess the giant component from a sample of
+// labels and only process the full neighborhoods of nodes that ended up outside of it.
+std::vector<unsigned int> GraphData::weaklyConnectedComponentLabels()
+{
+    constexpr unsigned int kNeighborRounds = 2;
+    constexpr unsigned int kSampleCount = 1024;
+
+    const CompactGraph& graph = getCompactGraph();
+    const unsigned int nodeCount = graph.getNodeCount();
+    ConcurrentUnionFind components{ nodeCount };
+
+    for (unsigned int round = 0; round < kNeighborRounds; ++round)
+    {
+        parallelFor(0, nodeCount, [&](unsigned int nodeID)
+        {
+            auto neighbors = graph.getOutNeighbors(nodeID);
+            if (round < neighbors.size())
             {
-                if (unvisited.contains(adjNode))
-                {
-                    foundAdjNode = true;
-                    visited.push(adjNode);
-                    currentComponent.push_back(adjNode);
-                    unvisited.erase(adjNode);
-                    break;
-                }
+                components.unite(nodeID, neighbors[round]);
             }
+        });
+        components.compress();
+    }
 
-            if (!foundAdjNode)
+    unsigned int largestComponent = 0;
+    if (nodeCount > 0)
+    {
+        std::mt19937 generator{ 27491095 };
+        std::uniform_int_distribution<unsigned int> distribution{ 0, nodeCount - 1 };
+        std::unordered_map<unsigned int, unsigned int> sampleCounts;
+        unsigned int largestCount = 0;
+
+        for (unsigned int sample = 0; sample < std::min(kSampleCount, nodeCount); ++sample)
+        {
+            unsigned int label = components.getParent(distribution(generator));
+            unsigned int count = ++sampleCounts[label];
+            if (count > largestCount)
             {
-                visitedAndAnalyzed.push(nodeToVisit);
-                visited.pop();
+                largestCount = count;
+                largestComponent = label;
             }
         }
+    }
 
-        components.push_back(currentComponent);
-
-        if (!unvisited.empty())
+    parallelFor(0, nodeCount, [&](unsigned int nodeID)
+    {
+        if (components.getParent(nodeID) == largestComponent)
         {
-            unsigned int newStartNode = *unvisited.begin();
-            unvisited.erase(newStartNode);
-
-            currentComponent.clear();
-            currentComponent.push_back(newStartNode);
+            return;
+        }
 
-            visited.push(newStartNode);
+        auto outNeighbors = graph.getOutNeighbors(nodeID);
+        for (unsigned int index = kNeighborRounds; index < outNeighbors.size(); ++index)
+        {
+            components.unite(nodeID, outNeighbors[index]);
         }
-    }
 
-    if (oriented)
-    {
-        this->setOriented(true);
-    }
+        if (m_oriented)
+        {
+            for (unsigned int inNeighbor : graph.getInNeighbors(nodeID))
+            {
+                components.unite(nodeID, inNeighbor);
+            }
+        }
+    });
+    components.compress();
 
-    return components;
+    return components.getLabels();
 }
 
 std::vector<unsigned int> GraphData::BFS(const GraphNode* const startNode) const
@@ -671,6 +1112,27 @@ std::pair<std::vector<std::pair<int, int>>, int> GraphData::fordFulkersonMinCut(
     return { minCutEdges, maxFlow };
 }
 
+// Capacities are the edge weights, as for fordFulkersonMinCut; edgeCosts holds one cost per edge in edge order.
+MinCostFlowResult GraphData::minCostFlow(unsigned int sourceNodeID, unsigned int sinkNodeID, const std::vector<int>& edgeCosts, long long flowLimit) const
+{
+    if (edgeCosts.size() != m_edges.size())
+    {
+        std::cout << "Expected " << m_edges.size() << " edge costs, got " << edgeCosts.size() << "\n";
+        MinCostFlowResult result;
+        result.feasible = false;
+        return result;
+    }
+
+    MinCostFlow minCostFlow;
+    minCostFlow.build(static_cast<unsigned int>(m_nodes.size()), m_edges, m_oriented, edgeCosts);
+    MinCostFlowResult result = minCostFlow.solve(sourceNodeID, sinkNodeID, flowLimit);
+    if (!result.feasible)
+    {
+        std::cout << "A negative cost cycle is reachable from the source\n";
+    }
+    return result;
+}
+
 void GraphData::bfsReachableNodes(
     unsigned int sourceID,
     const std::unordered_map<std::pair<int, int>, int, GraphData::PairHash>& residualCapacities,
@@ -749,45 +1211,112 @@ unsigned int GraphData::bfsFindAugmentingPath(
 
 std::vector<std::pair<int, int>> GraphData::primMST()
 {
-    int n = m_nodes.size();
-    std::unordered_set<int> resultingNodes;
-    std::unordered_map<int, int> lastNode;
+    if (isDenseMode())
+    {
+        return getDenseGraph().primMST();
+    }
+    return primMST<QuaternaryHeap>();
+}
+
+// Sparse graphs run one DFS per source in parallel, the row of the source doubling as its visited set.
+BitMatrix GraphData::transitiveClosure() const
+{
+    if (isDenseMode())
+    {
+        return getDenseGraph().transitiveClosure();
+    }
+
+    const CompactGraph& graph = getCompactGraph();
+    const unsigned int n = graph.getNodeCount();
+    BitMatrix closure;
+    closure.resize(n);
+
+    std::vector<std::vector<unsigned int>> stacks(getParallelThreadCount());
+    parallelForChunks(0, n, 16, [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+    {
+        std::vector<unsigned int>& stack = stacks[threadIndex];
+        for (unsigned int sourceNodeID = chunkBegin; sourceNodeID < chunkEnd; ++sourceNodeID)
+        {
+            stack.assign(1, sourceNodeID);
+            while (!stack.empty())
+            {
+                unsigned int nodeID = stack.back();
+                stack.pop_back();
+                for (unsigned int adjNodeID : graph.getOutNeighbors(nodeID))
+                {
+                    if (!closure.test(sourceNodeID, adjNodeID))
+                    {
+                        closure.set(sourceNodeID, adjNodeID);
+                        stack.push_back(adjNodeID);
+                    }
+                }
+            }
+        }
+    });
+
+    return closure;
+}
+
+template <typename PriorityQueue>
+std::vector<std::pair<int, int>> GraphData::primMST() const
+{
+    static_assert(!PriorityQueue::kMonotoneOnly, "Prim's keys are not monotone");
+
+    const CompactGraph& graph = getCompactGraph();
+    const unsigned int n = graph.getNodeCount();
     std::vector<std::pair<int, int>> resultingEdges;
-    std::vector<int> minimumCostToReach(n, std::numeric_limits<int>::max());
+    if (n == 0)
+    {
+        return resultingEdges;
+    }
+
+    // keys are weights shifted by the smallest one so negative weights keep their order
+    int minimumWeight = 0;
+    for (const Edge& edge : m_edges)
+    {
+        minimumWeight = std::min(minimumWeight, edge.getWeight());
+    }
+
+    std::vector<bool> resultingNodes(n, false);
+    std::vector<unsigned int> lastNode(n, 0);
+    std::vector<unsigned int> minimumCostToReach(n, std::numeric_limits<unsigned int>::max());
     minimumCostToReach[0] = 0;
 
-    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> pq;
-    pq.push({ 0, 0 });
+    PriorityQueue pq;
+    pq.reset(n, graph.getMaxWeight());
+    pq.push(0, 0);
 
-    while (resultingNodes.size() < m_nodes.size())
+    while (!pq.empty())
     {
-        auto [cost, nodeID] = pq.top();
-        pq.pop();
+        auto [cost, nodeID] = pq.pop();
 
-        if (resultingNodes.contains(nodeID))
+        if (resultingNodes[nodeID] || cost > minimumCostToReach[nodeID])
         {
             continue;
         }
-        resultingNodes.insert(nodeID);
+        resultingNodes[nodeID] = true;
 
         if (nodeID != 0)
         {
             resultingEdges.push_back({ nodeID, lastNode[nodeID] });
         }
 
-        for (unsigned int adjNodeID : m_adjacencyList[nodeID])
+        auto neighbors = graph.getOutNeighbors(nodeID);
+        auto edges = graph.getOutEdges(nodeID);
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
         {
-            if (resultingNodes.contains(adjNodeID))
+            unsigned int adjNodeID = neighbors[index];
+            if (resultingNodes[adjNodeID])
             {
                 continue;
             }
 
-            int weight = m_edgeWeights[{nodeID, adjNodeID}];
+            unsigned int weight = static_cast<unsigned int>(m_edges[edges[index]].getWeight() - minimumWeight);
             if (weight < minimumCostToReach[adjNodeID])
             {
                 lastNode[adjNodeID] = nodeID;
                 minimumCostToReach[adjNodeID] = weight;
-                pq.push({ weight, adjNodeID });
+                pq.push(adjNodeID, weight);
             }
         }
     }
@@ -862,38 +1391,6 @@ std::vector<std::pair<int, int>> GraphData::genericMST()
     return resultingEdges;
 }
 
-int find(int node, std::vector<int>& parent)
-{
-    if (parent[node] != node)
-    {
-        parent[node] = find(parent[node], parent);
-    }
-    return parent[node];
-}
-
-void unionSets(int node1, int node2, std::vector<int>& parent, std::vector<int>& rank)
-{
-    int root1 = find(node1, parent);
-    int root2 = find(node2, parent);
-
-    if (root1 != root2)
-    {
-        if (rank[root1] > rank[root2])
-        {
-            parent[root2] = root1;
-        }
-        else if (rank[root1] < rank[root2])
-        {
-            parent[root1] = root2;
-        }
-        else
-        {
-            parent[root2] = root1;
-            ++rank[root1];
-        }
-    }
-};
-
 std::vector<std::pair<int, int>> GraphData::kruskalMST()
 {
     std::vector<std::tuple<int, int, int>> edges;
@@ -903,20 +1400,14 @@ std::vector<std::pair<int, int>> GraphData::kruskalMST()
     }
     std::sort(edges.begin(), edges.end());
 
-    std::vector<int> parent(m_nodes.size());
-    std::vector<int> rank(m_nodes.size(), 0);
-    for (int i = 0; i < m_nodes.size(); ++i)
-    {
-        parent[i] = i;
-    }
+    UnionFind components{ static_cast<unsigned int>(m_nodes.size()) };
 
     std::vector<std::pair<int, int>> resultingEdges;
     for (const auto& [weight, node1, node2] : edges)
     {
-        if (find(node1, parent) != find(node2, parent))
+        if (components.unite(node1, node2))
         {
             resultingEdges.push_back({ node1, node2 });
-            unionSets(node1, node2, parent, rank);
 
             if (resultingEdges.size() == m_nodes.size() - 1)
             {
@@ -1027,71 +1518,160 @@ std::vector<unsigned int> GraphData::genericPathTraversal(const GraphNode* const
     return visitedAndAnalyzed;
 }
 
-std::vector<unsigned int> GraphData::topologicalSort(const GraphNode* const startNode)
+std::vector<unsigned int> GraphData::topologicalSort() const
 {
-    if (this->checkCycles())
+    if (isMaintainingTopologicalOrder() && m_topologicalOrder.isAcyclic())
+    {
+        return m_topologicalOrder.getOrder();
+    }
+
+    TopologicalOrder topologicalOrder = topologicalLevels();
+
+    if (!topologicalOrder.cycle.empty())
     {
         std::cout << "Can't perform topological sort on a graph with cycles\n";
         return {};
     }
 
-    unsigned int startNodeID = startNode->getInternalID();
-    std::cout << "Start node: " << startNodeID << "\n";
-    std::stack<unsigned int> visited; visited.push(startNodeID);
-    std::stack<unsigned int> visitedAndAnalyzed;
+    return topologicalOrder.order;
+}
 
-    std::unordered_set<unsigned int> unvisited;
-    for (const auto node : m_nodes)
+// The index is built on the first query after the graph changed.
+bool GraphData::canReach(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    getReachabilityIndex();
+    return m_reachabilityIndex.canReach(sourceNodeID, targetNodeID);
+}
+
+const ReachabilityIndex& GraphData::getReachabilityIndex() const
+{
+    const CompactGraph& graph = getCompactGraph();
+    if (!m_reachabilityIndex.isBuilt())
     {
-        unsigned int nodeID = node->getInternalID();
-        if (nodeID != startNodeID)
-        {
-            unvisited.insert(nodeID);
-        }
+        m_reachabilityIndex.build(graph);
     }
+    return m_reachabilityIndex;
+}
 
-    while (!unvisited.empty())
+bool GraphData::hasEdge(unsigned int startNodeID, unsigned int endNodeID) const
+{
+    if (startNodeID >= m_nodes.size() || endNodeID >= m_nodes.size())
     {
-        while (!visited.empty())
+        return false;
+    }
+    if (isDenseMode())
+    {
+        return getDenseGraph().hasEdge(startNodeID, endNodeID);
+    }
+    return m_adjacencyList[startNodeID].contains(endNodeID);
+}
+
+// Switches on the density the statistics measure as the graph is edited.
+bool GraphData::isDenseMode() const
+{
+    return DenseGraph::isWorthwhile(static_cast<unsigned int>(m_nodes.size()), m_statistics.density);
+}
+
+const DenseGraph& GraphData::getDenseGraph() const
+{
+    getCompactGraph();
+    if (!m_denseGraph.isBuilt())
+    {
+        m_denseGraph.build(static_cast<unsigned int>(m_nodes.size()), m_edges, m_oriented);
+    }
+    return m_denseGraph;
+}
+
+// Level-synchronous Kahn: every level is an antichain, large frontiers are expanded in parallel.
+// Whatever is left with a non-zero in-degree lies on or behind a cycle, a witness is recovered from it.
+GraphData::TopologicalOrder GraphData::topologicalLevels() const
+{
+    constexpr unsigned int kParallelFrontierSize = 4096;
+
+    const CompactGraph& graph = getCompactGraph();
+    const unsigned int nodeCount = graph.getNodeCount();
+
+    std::vector<std::atomic<unsigned int>> inDegree(nodeCount);
+    std::vector<unsigned int> frontier;
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        unsigned int degree = static_cast<unsigned int>(graph.getInNeighbors(nodeID).size());
+        inDegree[nodeID].store(degree, std::memory_order_relaxed);
+        if (degree == 0)
         {
-            unsigned int nodeToVisit = visited.top();
+            frontier.push_back(nodeID);
+        }
+    }
 
-            bool foundAdjNode = false;
+    TopologicalOrder topologicalOrder;
+    topologicalOrder.order.reserve(nodeCount);
 
-            for (unsigned int adjNode : m_adjacencyList[nodeToVisit])
-            {
-                if (unvisited.contains(adjNode))
-                {
-                    foundAdjNode = true;
-                    visited.push(adjNode);
-                    unvisited.erase(adjNode);
-                    break;
-                }
-            }
+    std::vector<unsigned int> nextFrontier(nodeCount);
+    std::atomic<unsigned int> nextFrontierSize{ 0 };
 
-            if (!foundAdjNode)
+    auto relaxNode = [&](unsigned int nodeID)
+    {
+        for (unsigned int adjNodeID : graph.getOutNeighbors(nodeID))
+        {
+            if (inDegree[adjNodeID].fetch_sub(1, std::memory_order_relaxed) == 1)
             {
-                visitedAndAnalyzed.push(nodeToVisit);
-                unvisited.erase(nodeToVisit);
-                visited.pop();
+                nextFrontier[nextFrontierSize.fetch_add(1, std::memory_order_relaxed)] = adjNodeID;
             }
         }
+    };
 
-        if (!unvisited.empty())
+    while (!frontier.empty())
+    {
+        nextFrontierSize.store(0, std::memory_order_relaxed);
+
+        if (frontier.size() >= kParallelFrontierSize)
         {
-            unsigned int newStartNode = *unvisited.begin();
-            visited.push(newStartNode);
+            parallelFor(0, static_cast<unsigned int>(frontier.size()), [&](unsigned int index) { relaxNode(frontier[index]); });
+        }
+        else
+        {
+            std::for_each(frontier.begin(), frontier.end(), relaxNode);
         }
+
+        topologicalOrder.order.insert(topologicalOrder.order.end(), frontier.begin(), frontier.end());
+        topologicalOrder.levels.push_back(std::move(frontier));
+
+        frontier.assign(nextFrontier.begin(), nextFrontier.begin() + nextFrontierSize.load(std::memory_order_relaxed));
+        std::sort(frontier.begin(), frontier.end());
     }
 
-    std::vector<unsigned int> topoSort;
-    while (!visitedAndAnalyzed.empty())
+    if (topologicalOrder.order.size() == nodeCount)
     {
-        topoSort.push_back(visitedAndAnalyzed.top());
-        visitedAndAnalyzed.pop();
+        return topologicalOrder;
     }
 
-    return topoSort;
+    unsigned int nodeID = 0;
+    while (inDegree[nodeID].load(std::memory_order_relaxed) == 0)
+    {
+        ++nodeID;
+    }
+
+    std::vector<int> walkPosition(nodeCount, -1);
+    std::vector<unsigned int> walk;
+    while (walkPosition[nodeID] == -1)
+    {
+        walkPosition[nodeID] = static_cast<int>(walk.size());
+        walk.push_back(nodeID);
+
+        for (unsigned int predecessorID : graph.getInNeighbors(nodeID))
+        {
+            if (inDegree[predecessorID].load(std::memory_order_relaxed) > 0)
+            {
+                nodeID = predecessorID;
+                break;
+            }
+        }
+    }
+
+    topologicalOrder.cycle.assign(walk.rbegin(), walk.rend() - walkPosition[nodeID]);
+    topologicalOrder.cycle.push_back(topologicalOrder.cycle.front());
+
+    return topologicalOrder;
 }
 
 std::vector<unsigned int> GraphData::totalGenericPathTraversal(const GraphNode* const startNode) const 
@@ -1151,8 +1731,19 @@ bool GraphData::isOriented() const
    return m_oriented;
 }
 
+bool GraphData::isMaintainingTopologicalOrder() const
+{
+    return m_maintainTopologicalOrder && m_oriented;
+}
+
+const DynamicTopologicalOrder& GraphData::getDynamicTopologicalOrder() const
+{
+    return m_topologicalOrder;
+}
+
 void GraphData::updateAdjacencyList()
 {
+    m_compactGraphDirty = true;
     m_adjacencyList.clear();
     m_adjacencyList.resize(m_nodes.size());
 
@@ -1167,4 +1758,106 @@ void GraphData::updateAdjacencyList()
             m_adjacencyList[endNodeID].insert(startNodeID);
         }
     }
+
+    rebuildStatistics();
+    rebuildTopologicalOrder();
+}
+
+void GraphData::rebuildStatistics()
+{
+    m_weakComponents.reset(0);
+    m_inDegree.clear();
+    m_outDegree.clear();
+    m_sourceNodes.clear();
+
+    m_statistics = Statistics{};
+    m_statistics.oriented = m_oriented;
+    m_statistics.weighted = m_weighted;
+    m_statistics.degreeHistogram.push_back(0);
+
+    for (const auto& node : m_nodes)
+    {
+        countNode(node->getInternalID());
+    }
+
+    for (const auto& edge : m_edges)
+    {
+        countEdge(edge.getStartNode()->getInternalID(), edge.getEndNode()->getInternalID());
+    }
+
+    updateDensity();
+}
+
+void GraphData::countNode(unsigned int nodeID)
+{
+    m_weakComponents.addElement();
+    m_inDegree.push_back(0);
+    m_outDegree.push_back(0);
+    m_sourceNodes.insert(nodeID);
+
+    ++m_statistics.nodeCount;
+    ++m_statistics.sourceCount;
+    ++m_statistics.sinkCount;
+    ++m_statistics.degreeHistogram[0];
+    m_statistics.weakComponentCount = m_weakComponents.getComponentCount();
+}
+
+void GraphData::countEdge(unsigned int startNodeID, unsigned int endNodeID)
+{
+    m_weakComponents.unite(startNodeID, endNodeID);
+
+    countDegreeIncrease(startNodeID);
+    if (m_outDegree[startNodeID]++ == 0)
+    {
+        --m_statistics.sinkCount;
+    }
+
+    countDegreeIncrease(endNodeID);
+    if (m_inDegree[endNodeID]++ == 0)
+    {
+        --m_statistics.sourceCount;
+        m_sourceNodes.erase(endNodeID);
+    }
+
+    ++m_statistics.edgeCount;
+    if (startNodeID == endNodeID)
+    {
+        ++m_statistics.selfLoopCount;
+    }
+    m_statistics.weakComponentCount = m_weakComponents.getComponentCount();
+}
+
+void GraphData::countDegreeIncrease(unsigned int nodeID)
+{
+    std::vector<unsigned int>& histogram = m_statistics.degreeHistogram;
+    unsigned int degree = m_inDegree[nodeID] + m_outDegree[nodeID];
+
+    --histogram[degree];
+    if (histogram.size() == degree + 1)
+    {
+        histogram.push_back(0);
+    }
+    ++histogram[degree + 1];
+
+    m_statistics.maxDegree = std::max(m_statistics.maxDegree, degree + 1);
+}
+
+void GraphData::updateDensity()
+{
+    double nodeCount = m_statistics.nodeCount;
+    double possibleEdges = m_oriented ? nodeCount * (nodeCount - 1.0) : nodeCount * (nodeCount - 1.0) / 2.0;
+
+    m_statistics.density = possibleEdges > 0.0 ? static_cast<float>(m_statistics.edgeCount / possibleEdges) : 0.0f;
+}
+
+void GraphData::rebuildTopologicalOrder()
+{
+    if (!isMaintainingTopologicalOrder())
+    {
+        m_topologicalOrder.clear();
+        return;
+    }
+
+    TopologicalOrder topologicalOrder = topologicalLevels();
+    m_topologicalOrder.rebuild(getCompactGraph(), topologicalOrder.order, topologicalOrder.cycle);
 }
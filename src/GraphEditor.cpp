@@ -4,6 +4,8 @@
 #include "imgui/imgui_impl_opengl3.h"
 #include "ResourceManager.h"
 #include "GLFW/glfw3.h"
+#include <chrono>
+#include <fstream>
 #include <thread>
 #include <sstream>
 
@@ -16,6 +18,8 @@
 
 GraphEditor::GraphEditor()
     : m_graphData{}, m_renderer{}, m_selectedNode{nullptr}
+    , m_routeSourceID{ PathQueryResult::kUnreachable }, m_routeTargetID{ PathQueryResult::kUnreachable }, m_routeEdges{}
+    , m_routeEdgeColors{}, m_routeVersion{ 0 }
 {
     m_graphData.setLogAdjacency(true);
 }
@@ -194,6 +198,7 @@ bool GraphEditor::checkEdgeSelect(glm::vec2 position)
     }
 
     constexpr float selectionThreshold = 10.0f;
+    dropStaleRoute();
 
     for (auto& edge : m_graphData.getEdgesRef())
     {
@@ -217,9 +222,9 @@ bool GraphEditor::checkEdgeSelect(glm::vec2 position)
                 int weight = 0;
                 std::cin >> weight;
 
-                edge.setWeight(weight);
                 //TODO: undo, clear, ...
-                m_graphData.getEdgeWeights()[{edge.getStartNode()->getInternalID(), edge.getEndNode()->getInternalID()}] = weight;
+                m_graphData.setEdgeWeight(edge, weight);
+                highlightRoute();
                 return true;
             }
 
@@ -229,9 +234,8 @@ bool GraphEditor::checkEdgeSelect(glm::vec2 position)
                 int weight = 0;
                 std::cin >> weight;
 
-                edge.setWeight(weight);
-                m_graphData.getEdgeWeights()[{edge.getStartNode()->getInternalID(), edge.getEndNode()->getInternalID()}] = weight;
-                m_graphData.getEdgeWeights()[{edge.getEndNode()->getInternalID(), edge.getStartNode()->getInternalID()}] = weight;
+                m_graphData.setEdgeWeight(edge, weight);
+                highlightRoute();
                 return true;
             }
         }
@@ -239,6 +243,146 @@ bool GraphEditor::checkEdgeSelect(glm::vec2 position)
     return false;
 }
 
+void GraphEditor::showRoute(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    if (sourceNodeID >= m_graphData.getNodes().size() || targetNodeID >= m_graphData.getNodes().size())
+    {
+        std::cout << "Invalid route endpoints\n";
+        return;
+    }
+
+    dropStaleRoute();
+    m_routeSourceID = sourceNodeID;
+    m_routeTargetID = targetNodeID;
+    highlightRoute();
+}
+
+// The route comes from the dynamic shortest path tree, so after a weight edit only the affected part is recomputed.
+void GraphEditor::highlightRoute()
+{
+    if (m_routeSourceID == PathQueryResult::kUnreachable)
+    {
+        return;
+    }
+
+    auto& edges = m_graphData.getEdgesRef();
+    for (unsigned int index = 0; index < m_routeEdges.size(); ++index)
+    {
+        edges[m_routeEdges[index]].setColor(m_routeEdgeColors[index]);
+    }
+
+    PathQueryResult route = m_graphData.dynamicShortestPath(m_routeSourceID, m_routeTargetID);
+    m_routeEdges = route.edges;
+    m_routeEdgeColors.clear();
+    for (unsigned int edgeIndex : m_routeEdges)
+    {
+        m_routeEdgeColors.push_back(edges[edgeIndex].getColor());
+        edges[edgeIndex].setColor(glm::vec4{ 0.0f, 1.0f, 0.0f, 1.0f });
+    }
+    m_routeVersion = m_graphData.getVersion();
+
+    if (!route.isReachable())
+    {
+        std::cout << "No path between " << m_routeSourceID << " and " << m_routeTargetID << "\n";
+        return;
+    }
+    for (unsigned int nodeID : route.path)
+    {
+        std::cout << nodeID << "\n";
+    }
+    std::cout << "distance: " << route.distance << "\n";
+}
+
+// Any change besides the weight edits made through checkEdgeSelect, such as clear or undo, may have renumbered the nodes
+// and edges, so the route is forgotten rather than recolored by index.
+void GraphEditor::dropStaleRoute()
+{
+    if (m_routeSourceID != PathQueryResult::kUnreachable && m_graphData.getVersion() != m_routeVersion)
+    {
+        m_routeSourceID = PathQueryResult::kUnreachable;
+        m_routeTargetID = PathQueryResult::kUnreachable;
+        m_routeEdges.clear();
+        m_routeEdgeColors.clear();
+    }
+}
+
+void GraphEditor::runBatchQueries(const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open())
+    {
+        std::cout << "Can't open file at: " << filePath << "\n";
+        return;
+    }
+
+    std::vector<std::pair<unsigned int, unsigned int>> queries;
+    unsigned int sourceNodeID, targetNodeID;
+    while (file >> sourceNodeID >> targetNodeID)
+    {
+        queries.push_back({ sourceNodeID, targetNodeID });
+    }
+
+    BatchQueryResult result = m_graphData.batchShortestPaths(queries);
+    for (unsigned int queryIndex = 0; queryIndex < queries.size(); ++queryIndex)
+    {
+        std::cout << queries[queryIndex].first << " -> " << queries[queryIndex].second << ": ";
+        if (result.distances[queryIndex] == PathQueryResult::kUnreachable)
+        {
+            std::cout << "unreachable\n";
+        }
+        else
+        {
+            std::cout << result.distances[queryIndex] << "\n";
+        }
+    }
+    std::cout << queries.size() << " queries in " << result.seconds * 1000.0 << " ms, " << result.getQueriesPerSecond() << " queries/s\n";
+}
+
+void GraphEditor::runMinCostFlow(unsigned int sourceNodeID, unsigned int sinkNodeID, const std::string& costsFilePath)
+{
+    std::ifstream file(costsFilePath);
+    if (!file.is_open())
+    {
+        std::cout << "Can't open file at: " << costsFilePath << "\n";
+        return;
+    }
+
+    std::vector<int> edgeCosts;
+    int cost;
+    while (file >> cost)
+    {
+        edgeCosts.push_back(cost);
+    }
+
+    MinCostFlowResult result = m_graphData.minCostFlow(sourceNodeID, sinkNodeID, edgeCosts);
+    if (!result.feasible)
+    {
+        return;
+    }
+
+    auto& edges = m_graphData.getEdgesRef();
+    for (unsigned int edgeIndex = 0; edgeIndex < edges.size(); ++edgeIndex)
+    {
+        if (result.edgeFlows[edgeIndex] != 0)
+        {
+            std::cout << edges[edgeIndex].getStartNode()->getInternalID() << " " << edges[edgeIndex].getEndNode()->getInternalID()
+                      << ": " << result.edgeFlows[edgeIndex] << "\n";
+            edges[edgeIndex].setColor(glm::vec4{ 0.0f, 0.0f, 1.0f, 1.0f });
+        }
+    }
+    std::cout << "The flow is " << result.flow << " at cost " << result.cost << ", " << result.augmentations << " augmentations\n";
+}
+
+void GraphEditor::exportAllPairsShortestPaths(const std::string& filePath)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (m_graphData.saveAllPairsShortestPaths(filePath))
+    {
+        std::cout << "Saved the " << m_graphData.getSize() << "x" << m_graphData.getSize() << " distance matrix to " << filePath << " in "
+                  << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
+    }
+}
+
 void GraphEditor::tryAddEdge(GraphNode* edgeStart, GraphNode* edgeEnd)
 {
     if (edgeStart->getPosition() == edgeEnd->getPosition())
@@ -264,9 +408,21 @@ void GraphEditor::tryAddEdge(GraphNode* edgeStart, GraphNode* edgeEnd)
         }
     }
 
+    bool wasAcyclic = m_graphData.getDynamicTopologicalOrder().isAcyclic();
+
     m_graphData.addEdge(edgeStart, edgeEnd);
     m_selectedNode = nullptr;
 
+    if (m_graphData.isMaintainingTopologicalOrder() && wasAcyclic && !m_graphData.getDynamicTopologicalOrder().isAcyclic())
+    {
+        std::cout << "The new edge closes a cycle: ";
+        for (unsigned int nodeID : m_graphData.getDynamicTopologicalOrder().getCycle())
+        {
+            std::cout << nodeID << " ";
+        }
+        std::cout << "\n";
+    }
+
     for (const auto& edge : m_graphData.getEdges())
     {
         LOG("Current edges: \n"
@@ -0,0 +1,228 @@
+#include "HubLabels.h"
+#include "Parallel.h"
+#include <algorithm>
+
+static constexpr unsigned int kSentinelHub = 0xFFFFFFFF;
+
+namespace
+{
+    struct LabelEntry
+    {
+        unsigned int hub;
+        unsigned int distance;
+    };
+
+    void sortAndMerge(std::vector<LabelEntry>& entries)
+    {
+        std::sort(entries.begin(), entries.end(), [](const LabelEntry& first, const LabelEntry& second)
+        {
+            return first.hub < second.hub || (first.hub == second.hub && first.distance < second.distance);
+        });
+        entries.erase(std::unique(entries.begin(), entries.end(), [](const LabelEntry& first, const LabelEntry& second) { return first.hub == second.hub; }), entries.end());
+    }
+
+    unsigned int mergeEntries(const std::vector<LabelEntry>& first, const std::vector<LabelEntry>& second)
+    {
+        unsigned int best = PathQueryResult::kUnreachable;
+        for (std::size_t firstIndex = 0, secondIndex = 0; firstIndex < first.size() && secondIndex < second.size(); )
+        {
+            if (first[firstIndex].hub == second[secondIndex].hub)
+            {
+                best = std::min(best, first[firstIndex++].distance + second[secondIndex++].distance);
+            }
+            else if (first[firstIndex].hub < second[secondIndex].hub)
+            {
+                ++firstIndex;
+            }
+            else
+            {
+                ++secondIndex;
+            }
+        }
+        return best;
+    }
+}
+
+HubLabels::HubLabels()
+    : m_nodeCount{ 0 }, m_forwardLabels{}, m_backwardLabels{}
+{}
+
+// Labels are filled top-down: a node's label is built from the labels of its upward neighbors, so all nodes whose
+// neighbors are done form a level that is filled in parallel. An entry is dropped when the labels already give
+// a shorter distance to its hub through another hub.
+void HubLabels::build(const ContractionHierarchy& hierarchy)
+{
+    clear();
+    const unsigned int nodeCount = hierarchy.getNodeCount();
+    const auto& arcs = hierarchy.getArcs();
+
+    std::vector<unsigned int> nodesByRank(nodeCount);
+    for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+    {
+        nodesByRank[hierarchy.getRank(nodeID)] = nodeID;
+    }
+
+    std::vector<unsigned int> levels(nodeCount, 0);
+    std::vector<std::vector<unsigned int>> nodesByLevel;
+    for (auto it = nodesByRank.rbegin(); it != nodesByRank.rend(); ++it)
+    {
+        unsigned int nodeID = *it;
+        for (unsigned int arcID : hierarchy.getUpwardArcs(nodeID))
+        {
+            levels[nodeID] = std::max(levels[nodeID], levels[arcs[arcID].endNodeID] + 1);
+        }
+        for (unsigned int arcID : hierarchy.getDownwardArcs(nodeID))
+        {
+            levels[nodeID] = std::max(levels[nodeID], levels[arcs[arcID].startNodeID] + 1);
+        }
+
+        if (levels[nodeID] >= nodesByLevel.size())
+        {
+            nodesByLevel.resize(levels[nodeID] + 1);
+        }
+        nodesByLevel[levels[nodeID]].push_back(nodeID);
+    }
+
+    std::vector<std::vector<LabelEntry>> forwardLabels(nodeCount), backwardLabels(nodeCount);
+    for (const auto& level : nodesByLevel)
+    {
+        parallelFor(0, static_cast<unsigned int>(level.size()), [&](unsigned int index)
+        {
+            unsigned int nodeID = level[index];
+
+            std::vector<LabelEntry> forward{ { nodeID, 0 } };
+            for (unsigned int arcID : hierarchy.getUpwardArcs(nodeID))
+            {
+                for (const LabelEntry& entry : forwardLabels[arcs[arcID].endNodeID])
+                {
+                    forward.push_back({ entry.hub, entry.distance + arcs[arcID].weight });
+                }
+            }
+            sortAndMerge(forward);
+
+            std::vector<LabelEntry> backward{ { nodeID, 0 } };
+            for (unsigned int arcID : hierarchy.getDownwardArcs(nodeID))
+            {
+                for (const LabelEntry& entry : backwardLabels[arcs[arcID].startNodeID])
+                {
+                    backward.push_back({ entry.hub, entry.distance + arcs[arcID].weight });
+                }
+            }
+            sortAndMerge(backward);
+
+            auto& prunedForward = forwardLabels[nodeID];
+            for (const LabelEntry& entry : forward)
+            {
+                if (entry.hub == nodeID || mergeEntries(forward, backwardLabels[entry.hub]) >= entry.distance)
+                {
+                    prunedForward.push_back(entry);
+                }
+            }
+
+            auto& prunedBackward = backwardLabels[nodeID];
+            for (const LabelEntry& entry : backward)
+            {
+                if (entry.hub == nodeID || mergeEntries(forwardLabels[entry.hub], backward) >= entry.distance)
+                {
+                    prunedBackward.push_back(entry);
+                }
+            }
+        }, 16);
+    }
+
+    auto flatten = [nodeCount](const std::vector<std::vector<LabelEntry>>& labels, Label& label)
+    {
+        label.offsets.resize(nodeCount + 1);
+        label.offsets[0] = 0;
+        for (unsigned int nodeID = 0; nodeID < nodeCount; ++nodeID)
+        {
+            label.offsets[nodeID + 1] = label.offsets[nodeID] + static_cast<unsigned int>(labels[nodeID].size()) + 1;
+        }
+
+        label.hubs.resize(label.offsets[nodeCount]);
+        label.distances.resize(label.offsets[nodeCount]);
+        parallelFor(0, nodeCount, [&](unsigned int nodeID)
+        {
+            unsigned int position = label.offsets[nodeID];
+            for (const LabelEntry& entry : labels[nodeID])
+            {
+                label.hubs[position] = entry.hub;
+                label.distances[position++] = entry.distance;
+            }
+            label.hubs[position] = kSentinelHub;
+            label.distances[position] = 0;
+        });
+    };
+
+    flatten(forwardLabels, m_forwardLabels);
+    flatten(backwardLabels, m_backwardLabels);
+    m_nodeCount = nodeCount;
+}
+
+void HubLabels::clear()
+{
+    m_nodeCount = 0;
+    m_forwardLabels = {};
+    m_backwardLabels = {};
+}
+
+unsigned int HubLabels::distance(unsigned int sourceNodeID, unsigned int targetNodeID) const
+{
+    unsigned int forwardBegin = m_forwardLabels.offsets[sourceNodeID];
+    unsigned int backwardBegin = m_backwardLabels.offsets[targetNodeID];
+    return mergeDistance(m_forwardLabels.hubs.data() + forwardBegin, m_forwardLabels.distances.data() + forwardBegin
+                        , m_backwardLabels.hubs.data() + backwardBegin, m_backwardLabels.distances.data() + backwardBegin);
+}
+
+// Both runs end with the sentinel hub, so the loop needs no bounds checks and the advances are plain additions.
+unsigned int HubLabels::mergeDistance(const unsigned int* firstHubs, const unsigned int* firstDistances
+                                     , const unsigned int* secondHubs, const unsigned int* secondDistances)
+{
+    unsigned long long best = PathQueryResult::kUnreachable;
+    while (true)
+    {
+        unsigned int firstHub = *firstHubs;
+        unsigned int secondHub = *secondHubs;
+        if (firstHub == secondHub)
+        {
+            if (firstHub == kSentinelHub)
+            {
+                break;
+            }
+            best = std::min(best, static_cast<unsigned long long>(*firstDistances) + *secondDistances);
+        }
+
+        unsigned int firstStep = firstHub <= secondHub;
+        unsigned int secondStep = secondHub <= firstHub;
+        firstHubs += firstStep;
+        firstDistances += firstStep;
+        secondHubs += secondStep;
+        secondDistances += secondStep;
+    }
+    return static_cast<unsigned int>(best);
+}
+
+bool HubLabels::isBuilt() const
+{
+    return m_nodeCount > 0;
+}
+
+double HubLabels::getAverageLabelSize() const
+{
+    if (m_nodeCount == 0)
+    {
+        return 0.0;
+    }
+    // every run carries one sentinel
+    return static_cast<double>(m_forwardLabels.hubs.size() + m_backwardLabels.hubs.size() - 2ull * m_nodeCount) / (2.0 * m_nodeCount);
+}
+
+unsigned long long HubLabels::getMemoryUsage() const
+{
+    unsigned long long usage = 0;
+    for (const Label* label : { &m_forwardLabels, &m_backwardLabels })
+    {
+        usage += (label->offsets.size() + label->hubs.size() + label->distances.size()) * sizeof(unsigned int);
+    }
+    return usage;
+}
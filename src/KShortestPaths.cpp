@@ -0,0 +1,241 @@
+#include "KShortestPaths.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <set>
+
+std::vector<PathQueryResult> KShortestPaths::compute(const CompactGraph& graph, unsigned int sourceNodeID, unsigned int targetNodeID, unsigned int pathCount)
+{
+    std::vector<PathQueryResult> paths;
+    const unsigned int nodeCount = graph.getNodeCount();
+    if (pathCount == 0 || sourceNodeID >= nodeCount || targetNodeID >= nodeCount)
+    {
+        return paths;
+    }
+
+    ReverseTree tree;
+    buildReverseTree(graph, targetNodeID, tree);
+    if (tree.distances[sourceNodeID] == PathQueryResult::kUnreachable)
+    {
+        return paths;
+    }
+
+    PathQueryResult shortestPath;
+    shortestPath.distance = tree.distances[sourceNodeID];
+    shortestPath.path.push_back(sourceNodeID);
+    for (unsigned int nodeID = sourceNodeID; nodeID != targetNodeID; nodeID = tree.nextNodes[nodeID])
+    {
+        shortestPath.edges.push_back(tree.nextEdges[nodeID]);
+        shortestPath.path.push_back(tree.nextNodes[nodeID]);
+    }
+    paths.push_back(std::move(shortestPath));
+
+    std::vector<Workspace> workspaces(getParallelThreadCount());
+    std::vector<PathQueryResult> candidates;
+    std::set<std::vector<unsigned int>> knownPaths{ paths.front().edges };
+
+    while (paths.size() < pathCount)
+    {
+        const PathQueryResult& previousPath = paths.back();
+        const unsigned int spurCount = static_cast<unsigned int>(previousPath.path.size()) - 1;
+
+        std::vector<PathQueryResult> spurPaths(spurCount);
+        parallelForChunks(0, spurCount, 1, [&](unsigned int threadIndex, unsigned int chunkBegin, unsigned int chunkEnd)
+        {
+            for (unsigned int spurIndex = chunkBegin; spurIndex < chunkEnd; ++spurIndex)
+            {
+                // every accepted path sharing this root continues over an arc the spur must not take again
+                std::vector<unsigned int> bannedEdges;
+                for (const PathQueryResult& path : paths)
+                {
+                    if (path.edges.size() > spurIndex && std::equal(previousPath.edges.begin(), previousPath.edges.begin() + spurIndex, path.edges.begin()))
+                    {
+                        bannedEdges.push_back(path.edges[spurIndex]);
+                    }
+                }
+                spurPaths[spurIndex] = spurSearch(graph, tree, previousPath, spurIndex, bannedEdges, workspaces[threadIndex]);
+            }
+        });
+
+        for (PathQueryResult& spurPath : spurPaths)
+        {
+            if (spurPath.isReachable() && knownPaths.insert(spurPath.edges).second)
+            {
+                candidates.push_back(std::move(spurPath));
+            }
+        }
+        if (candidates.empty())
+        {
+            break;
+        }
+
+        auto best = std::min_element(candidates.begin(), candidates.end(), [](const PathQueryResult& first, const PathQueryResult& second)
+        {
+            return first.distance < second.distance || (first.distance == second.distance && first.edges < second.edges);
+        });
+        paths.push_back(std::move(*best));
+        candidates.erase(best);
+    }
+    return paths;
+}
+
+void KShortestPaths::buildReverseTree(const CompactGraph& graph, unsigned int targetNodeID, ReverseTree& tree)
+{
+    const unsigned int nodeCount = graph.getNodeCount();
+    tree.distances.assign(nodeCount, PathQueryResult::kUnreachable);
+    tree.nextNodes.assign(nodeCount, PathQueryResult::kUnreachable);
+    tree.nextEdges.assign(nodeCount, PathQueryResult::kUnreachable);
+
+    QuaternaryHeap pq;
+    pq.reset(nodeCount, graph.getMaxWeight());
+    tree.distances[targetNodeID] = 0;
+    pq.push(targetNodeID, 0);
+
+    while (!pq.empty())
+    {
+        auto [currentCost, currentNode] = pq.pop();
+
+        auto neighbors = graph.getInNeighbors(currentNode);
+        auto weights = graph.getInWeights(currentNode);
+        auto edges = graph.getInEdges(currentNode);
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            unsigned int newCost = currentCost + weights[index];
+            if (newCost < tree.distances[adjNodeID])
+            {
+                tree.distances[adjNodeID] = newCost;
+                tree.nextNodes[adjNodeID] = currentNode;
+                tree.nextEdges[adjNodeID] = edges[index];
+                pq.push(adjNodeID, newCost);
+            }
+        }
+    }
+}
+
+// Finds the best path that follows previousPath up to its spurIndex-th node and then leaves it, avoiding the root
+// nodes and the banned arcs out of the spur node. The result is the whole source-to-target path.
+PathQueryResult KShortestPaths::spurSearch(const CompactGraph& graph, const ReverseTree& tree, const PathQueryResult& previousPath, unsigned int spurIndex
+                                          , const std::vector<unsigned int>& bannedEdges, Workspace& workspace)
+{
+    const unsigned int nodeCount = graph.getNodeCount();
+    const unsigned int spurNodeID = previousPath.path[spurIndex];
+    const unsigned int targetNodeID = previousPath.path.back();
+    if (workspace.epochs.size() != nodeCount)
+    {
+        workspace.epochs.assign(nodeCount, 0);
+        workspace.blocked.assign(nodeCount, 0);
+        workspace.distances.resize(nodeCount);
+        workspace.parentNodes.resize(nodeCount);
+        workspace.parentEdges.resize(nodeCount);
+        workspace.epoch = 0;
+    }
+    if (++workspace.epoch == 0)
+    {
+        std::fill(workspace.epochs.begin(), workspace.epochs.end(), 0);
+        std::fill(workspace.blocked.begin(), workspace.blocked.end(), 0);
+        workspace.epoch = 1;
+    }
+    for (unsigned int index = 0; index < spurIndex; ++index)
+    {
+        workspace.blocked[previousPath.path[index]] = workspace.epoch;
+    }
+
+    auto isBanned = [&](unsigned int nodeID, unsigned int edgeIndex)
+    {
+        return nodeID == spurNodeID && std::find(bannedEdges.begin(), bannedEdges.end(), edgeIndex) != bannedEdges.end();
+    };
+
+    PathQueryResult result;
+    unsigned int rootDistance = 0;
+    for (unsigned int index = 0; index < spurIndex; ++index)
+    {
+        auto edges = graph.getOutEdges(previousPath.path[index]);
+        auto position = std::find(edges.begin(), edges.end(), previousPath.edges[index]) - edges.begin();
+        rootDistance += graph.getOutWeights(previousPath.path[index])[position];
+    }
+
+    // the tree path is optimal whenever it is still allowed
+    bool treePathAllowed = tree.distances[spurNodeID] != PathQueryResult::kUnreachable;
+    for (unsigned int nodeID = spurNodeID; treePathAllowed && nodeID != targetNodeID; nodeID = tree.nextNodes[nodeID])
+    {
+        treePathAllowed = workspace.blocked[tree.nextNodes[nodeID]] != workspace.epoch && !isBanned(nodeID, tree.nextEdges[nodeID]);
+    }
+
+    std::vector<unsigned int> spurNodes, spurEdges;
+    unsigned int spurDistance = PathQueryResult::kUnreachable;
+    if (treePathAllowed)
+    {
+        spurDistance = tree.distances[spurNodeID];
+        for (unsigned int nodeID = spurNodeID; nodeID != targetNodeID; nodeID = tree.nextNodes[nodeID])
+        {
+            spurEdges.push_back(tree.nextEdges[nodeID]);
+            spurNodes.push_back(tree.nextNodes[nodeID]);
+        }
+    }
+    else
+    {
+        auto isLabeled = [&](unsigned int nodeID) { return workspace.epochs[nodeID] == workspace.epoch; };
+        workspace.queue.reset(nodeCount, 0);
+        workspace.epochs[spurNodeID] = workspace.epoch;
+        workspace.distances[spurNodeID] = 0;
+        workspace.queue.push(spurNodeID, tree.distances[spurNodeID]);
+
+        while (!workspace.queue.empty())
+        {
+            auto [currentKey, currentNode] = workspace.queue.pop();
+            ++result.settledNodes;
+            if (currentNode == targetNodeID)
+            {
+                spurDistance = workspace.distances[targetNodeID];
+                break;
+            }
+
+            unsigned int currentCost = workspace.distances[currentNode];
+            auto neighbors = graph.getOutNeighbors(currentNode);
+            auto weights = graph.getOutWeights(currentNode);
+            auto edges = graph.getOutEdges(currentNode);
+            for (unsigned int index = 0; index < neighbors.size(); ++index)
+            {
+                unsigned int adjNodeID = neighbors[index];
+                unsigned int newCost = currentCost + weights[index];
+                if (workspace.blocked[adjNodeID] == workspace.epoch || tree.distances[adjNodeID] == PathQueryResult::kUnreachable
+                    || isBanned(currentNode, edges[index]))
+                {
+                    continue;
+                }
+
+                if (!isLabeled(adjNodeID) || newCost < workspace.distances[adjNodeID])
+                {
+                    workspace.epochs[adjNodeID] = workspace.epoch;
+                    workspace.distances[adjNodeID] = newCost;
+                    workspace.parentNodes[adjNodeID] = currentNode;
+                    workspace.parentEdges[adjNodeID] = edges[index];
+                    workspace.queue.push(adjNodeID, newCost + tree.distances[adjNodeID]);
+                }
+            }
+        }
+
+        if (spurDistance != PathQueryResult::kUnreachable)
+        {
+            for (unsigned int nodeID = targetNodeID; nodeID != spurNodeID; nodeID = workspace.parentNodes[nodeID])
+            {
+                spurNodes.push_back(nodeID);
+                spurEdges.push_back(workspace.parentEdges[nodeID]);
+            }
+            std::reverse(spurNodes.begin(), spurNodes.end());
+            std::reverse(spurEdges.begin(), spurEdges.end());
+        }
+    }
+
+    if (spurDistance == PathQueryResult::kUnreachable)
+    {
+        return result;
+    }
+
+    result.path.assign(previousPath.path.begin(), previousPath.path.begin() + spurIndex + 1);
+    result.edges.assign(previousPath.edges.begin(), previousPath.edges.begin() + spurIndex);
+    result.path.insert(result.path.end(), spurNodes.begin(), spurNodes.end());
+    result.edges.insert(result.edges.end(), spurEdges.begin(), spurEdges.end());
+    result.distance = rootDistance + spurDistance;
+    return result;
+}
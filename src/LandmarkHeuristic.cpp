@@ -0,0 +1,290 @@
+#include "LandmarkHeuristic.h"
+#include "ShortestPathEngine.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+static constexpr unsigned int kLandmarkFileMagic = 0x31544C41; // "ALT1"
+
+LandmarkHeuristic::LandmarkHeuristic()
+    : m_nodeCount{ 0 }, m_targetNodeID{ 0 }, m_landmarks{}, m_fromLandmark{}, m_toLandmark{}
+{}
+
+void LandmarkHeuristic::build(const CompactGraph& graph, unsigned int landmarkCount, LandmarkSelection selection)
+{
+    clear();
+    m_nodeCount = graph.getNodeCount();
+    if (m_nodeCount == 0)
+    {
+        return;
+    }
+
+    std::mt19937 generator{ 27491095 };
+    std::uniform_int_distribution<unsigned int> distribution{ 0, m_nodeCount - 1 };
+
+    landmarkCount = std::min(landmarkCount, m_nodeCount);
+    while (m_landmarks.size() < landmarkCount)
+    {
+        unsigned int rootNodeID = distribution(generator);
+        unsigned int landmarkNodeID = selection == LandmarkSelection::avoid ? selectAvoid(graph, rootNodeID) : selectFarthest(graph, rootNodeID);
+        if (landmarkNodeID == kEstimateUnreachable)
+        {
+            break;
+        }
+        addLandmark(graph, landmarkNodeID);
+    }
+}
+
+void LandmarkHeuristic::clear()
+{
+    m_nodeCount = 0;
+    m_targetNodeID = 0;
+    m_landmarks.clear();
+    m_fromLandmark.clear();
+    m_toLandmark.clear();
+}
+
+bool LandmarkHeuristic::save(const std::string& filePath, const CompactGraph& graph) const
+{
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cout << "Can't open file at: " << filePath << "\n";
+        return false;
+    }
+
+    unsigned int landmarkCount = static_cast<unsigned int>(m_landmarks.size());
+    unsigned long long fingerprint = graph.getFingerprint();
+    file.write(reinterpret_cast<const char*>(&kLandmarkFileMagic), sizeof(kLandmarkFileMagic));
+    file.write(reinterpret_cast<const char*>(&m_nodeCount), sizeof(m_nodeCount));
+    file.write(reinterpret_cast<const char*>(&landmarkCount), sizeof(landmarkCount));
+    file.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+    file.write(reinterpret_cast<const char*>(m_landmarks.data()), m_landmarks.size() * sizeof(unsigned int));
+    file.write(reinterpret_cast<const char*>(m_fromLandmark.data()), m_fromLandmark.size() * sizeof(unsigned int));
+    file.write(reinterpret_cast<const char*>(m_toLandmark.data()), m_toLandmark.size() * sizeof(unsigned int));
+    return static_cast<bool>(file);
+}
+
+bool LandmarkHeuristic::load(const std::string& filePath, const CompactGraph& graph)
+{
+    clear();
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    unsigned int magic = 0, nodeCount = 0, landmarkCount = 0;
+    unsigned long long fingerprint = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&nodeCount), sizeof(nodeCount));
+    file.read(reinterpret_cast<char*>(&landmarkCount), sizeof(landmarkCount));
+    file.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+    if (!file || magic != kLandmarkFileMagic || nodeCount != graph.getNodeCount() || fingerprint != graph.getFingerprint()
+        || landmarkCount > nodeCount)
+    {
+        std::cout << "Landmarks at " << filePath << " don't match the graph\n";
+        return false;
+    }
+
+    m_landmarks.resize(landmarkCount);
+    m_fromLandmark.resize(static_cast<std::size_t>(nodeCount) * landmarkCount);
+    m_toLandmark.resize(static_cast<std::size_t>(nodeCount) * landmarkCount);
+    file.read(reinterpret_cast<char*>(m_landmarks.data()), m_landmarks.size() * sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(m_fromLandmark.data()), m_fromLandmark.size() * sizeof(unsigned int));
+    file.read(reinterpret_cast<char*>(m_toLandmark.data()), m_toLandmark.size() * sizeof(unsigned int));
+    if (!file)
+    {
+        std::cout << "Landmarks at " << filePath << " are truncated\n";
+        clear();
+        return false;
+    }
+
+    m_nodeCount = nodeCount;
+    return true;
+}
+
+void LandmarkHeuristic::setTarget(unsigned int targetNodeID)
+{
+    m_targetNodeID = targetNodeID;
+}
+
+unsigned int LandmarkHeuristic::estimate(unsigned int nodeID) const
+{
+    return lowerBound(nodeID, m_targetNodeID);
+}
+
+// d(start, end) >= d(L, end) - d(L, start) and d(start, end) >= d(start, L) - d(end, L).
+// A landmark that reaches start but not end, or that end reaches but start doesn't, proves end unreachable.
+unsigned int LandmarkHeuristic::lowerBound(unsigned int startNodeID, unsigned int endNodeID) const
+{
+    const std::size_t landmarkCount = m_landmarks.size();
+    const unsigned int* fromStart = m_fromLandmark.data() + startNodeID * landmarkCount;
+    const unsigned int* fromEnd = m_fromLandmark.data() + endNodeID * landmarkCount;
+    const unsigned int* toStart = m_toLandmark.data() + startNodeID * landmarkCount;
+    const unsigned int* toEnd = m_toLandmark.data() + endNodeID * landmarkCount;
+
+    unsigned int bound = 0;
+    for (std::size_t index = 0; index < landmarkCount; ++index)
+    {
+        if (fromStart[index] != kEstimateUnreachable)
+        {
+            if (fromEnd[index] == kEstimateUnreachable)
+            {
+                return kEstimateUnreachable;
+            }
+            if (fromEnd[index] > fromStart[index])
+            {
+                bound = std::max(bound, fromEnd[index] - fromStart[index]);
+            }
+        }
+
+        if (toEnd[index] != kEstimateUnreachable)
+        {
+            if (toStart[index] == kEstimateUnreachable)
+            {
+                return kEstimateUnreachable;
+            }
+            if (toStart[index] > toEnd[index])
+            {
+                bound = std::max(bound, toStart[index] - toEnd[index]);
+            }
+        }
+    }
+    return bound;
+}
+
+bool LandmarkHeuristic::isBuilt() const
+{
+    return !m_landmarks.empty();
+}
+
+const std::vector<unsigned int>& LandmarkHeuristic::getLandmarks() const
+{
+    return m_landmarks;
+}
+
+void LandmarkHeuristic::addLandmark(const CompactGraph& graph, unsigned int landmarkNodeID)
+{
+    std::vector<unsigned int> distances[2];
+    parallelFor(0, graph.isOriented() ? 2 : 1, [&](unsigned int direction)
+    {
+        ShortestPathEngine::computeDistances(graph, landmarkNodeID, direction == 1, distances[direction]);
+    }, 1);
+    if (!graph.isOriented())
+    {
+        distances[1] = distances[0];
+    }
+
+    const std::size_t oldCount = m_landmarks.size();
+    const std::size_t newCount = oldCount + 1;
+    std::vector<unsigned int> fromLandmark(m_nodeCount * newCount);
+    std::vector<unsigned int> toLandmark(m_nodeCount * newCount);
+    for (std::size_t nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+    {
+        std::copy_n(m_fromLandmark.begin() + nodeID * oldCount, oldCount, fromLandmark.begin() + nodeID * newCount);
+        std::copy_n(m_toLandmark.begin() + nodeID * oldCount, oldCount, toLandmark.begin() + nodeID * newCount);
+        fromLandmark[nodeID * newCount + oldCount] = distances[0][nodeID];
+        toLandmark[nodeID * newCount + oldCount] = distances[1][nodeID];
+    }
+
+    m_landmarks.push_back(landmarkNodeID);
+    m_fromLandmark = std::move(fromLandmark);
+    m_toLandmark = std::move(toLandmark);
+}
+
+// The first landmark is the node farthest from startNodeID, every next one maximizes the distance to the closest landmark.
+unsigned int LandmarkHeuristic::selectFarthest(const CompactGraph& graph, unsigned int startNodeID) const
+{
+    const std::size_t landmarkCount = m_landmarks.size();
+    if (landmarkCount == 0)
+    {
+        std::vector<unsigned int> distances;
+        ShortestPathEngine::computeDistances(graph, startNodeID, false, distances);
+
+        unsigned int farthestNodeID = startNodeID;
+        for (unsigned int nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+        {
+            if (distances[nodeID] != kEstimateUnreachable && distances[nodeID] > distances[farthestNodeID])
+            {
+                farthestNodeID = nodeID;
+            }
+        }
+        return farthestNodeID;
+    }
+
+    unsigned int farthestNodeID = kEstimateUnreachable;
+    unsigned int farthestDistance = 0;
+    for (unsigned int nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+    {
+        const unsigned int* fromNode = m_fromLandmark.data() + nodeID * landmarkCount;
+        unsigned int closestDistance = *std::min_element(fromNode, fromNode + landmarkCount);
+        if (closestDistance > farthestDistance)
+        {
+            farthestDistance = closestDistance;
+            farthestNodeID = nodeID;
+        }
+    }
+    return farthestNodeID;
+}
+
+// Goldberg and Harrelson's avoid: weigh every node of a shortest path tree by how much the current landmarks
+// underestimate its distance from the root, then descend from the root into the heaviest landmark-free subtree.
+unsigned int LandmarkHeuristic::selectAvoid(const CompactGraph& graph, unsigned int rootNodeID) const
+{
+    if (m_landmarks.empty())
+    {
+        return selectFarthest(graph, rootNodeID);
+    }
+
+    std::vector<unsigned int> distances, parentNodes, settledOrder;
+    ShortestPathEngine::computeDistances(graph, rootNodeID, false, distances, &parentNodes, &settledOrder);
+
+    std::vector<bool> isLandmark(m_nodeCount, false);
+    for (unsigned int landmarkNodeID : m_landmarks)
+    {
+        isLandmark[landmarkNodeID] = true;
+    }
+
+    std::vector<unsigned long long> sizes(m_nodeCount, 0);
+    std::vector<bool> hasLandmark(m_nodeCount, false);
+    std::vector<unsigned int> heaviestChild(m_nodeCount, kEstimateUnreachable);
+    for (auto it = settledOrder.rbegin(); it != settledOrder.rend(); ++it)
+    {
+        unsigned int nodeID = *it;
+        sizes[nodeID] += distances[nodeID] - lowerBound(rootNodeID, nodeID);
+        if (isLandmark[nodeID] || hasLandmark[nodeID])
+        {
+            hasLandmark[nodeID] = true;
+            sizes[nodeID] = 0;
+        }
+
+        if (nodeID == rootNodeID)
+        {
+            continue;
+        }
+
+        unsigned int parentNodeID = parentNodes[nodeID];
+        sizes[parentNodeID] += sizes[nodeID];
+        hasLandmark[parentNodeID] = hasLandmark[parentNodeID] || hasLandmark[nodeID];
+        if (sizes[nodeID] > 0 && (heaviestChild[parentNodeID] == kEstimateUnreachable || sizes[nodeID] > sizes[heaviestChild[parentNodeID]]))
+        {
+            heaviestChild[parentNodeID] = nodeID;
+        }
+    }
+
+    unsigned int nodeID = rootNodeID;
+    while (heaviestChild[nodeID] != kEstimateUnreachable)
+    {
+        nodeID = heaviestChild[nodeID];
+    }
+
+    if (nodeID == rootNodeID)
+    {
+        return selectFarthest(graph, rootNodeID);
+    }
+    return nodeID;
+}
@@ -5,6 +5,9 @@
 #include "ResourceManager.h"
 #include "GLFW/glfw3.h"
 #include "pugixml/pugixml.hpp"
+#include <chrono>
+#include <cmath>
+#include <random>
 #include <thread>
 #include <sstream>
 
@@ -16,7 +19,8 @@
 #endif
 
 MapEditor::MapEditor()
-    : m_graphData{}, m_renderer{}, m_leftClickSelectedNode{nullptr}
+    : m_graphData{}, m_renderer{}, m_leftClickSelectedNode{nullptr}, m_routingAlgorithm{RoutingAlgorithm::contractionHierarchy}
+    , m_trafficApplied{false}, m_routeCache{kRouteCacheCapacity}
 {
     m_graphData.setLogAdjacency(true);
 }
@@ -41,6 +45,7 @@ void MapEditor::render()
         }
     }
     m_renderer.edgeInstanceRender(ResourceManager::getShader("edgeBatch")); 
+    m_renderer.highlightedEdgesRender(ResourceManager::getShader("edgeBatch"), glm::vec4{ 1.0f, 0.5f, 0.0f, 1.0f });
 }
 
 void MapEditor::handleInput()
@@ -58,15 +63,11 @@ void MapEditor::handleInput()
         double xPos, yPos;
         glfwGetCursorPos(window, &xPos, &yPos);
 
-        for (auto& node : m_graphData.getNodes())
+        if (GraphNode* node = findNodeAt(glm::vec2{ xPos, yPos }))
         {
-            if (glm::distance(node->getPosition(), glm::vec2{ xPos, yPos }) <= node->getSize().x)
-            {
-                m_leftClickSelectedNode = node;
-                std::cout << "Left click. Selected node. id:" << node->getInternalID() << ", pos: " 
-                          << node->getPosition().x << ", " << node->getPosition().y << "\n"; 
-                break;
-            }
+            m_leftClickSelectedNode = node;
+            std::cout << "Left click. Selected node. id:" << node->getInternalID() << ", pos: " 
+                      << node->getPosition().x << ", " << node->getPosition().y << "\n"; 
         }
     }
 
@@ -75,19 +76,24 @@ void MapEditor::handleInput()
         double xPos, yPos;
         glfwGetCursorPos(window, &xPos, &yPos);
 
-        for (auto& node : m_graphData.getNodes())
+        if (GraphNode* node = findNodeAt(glm::vec2{ xPos, yPos }))
         {
-            if (glm::distance(node->getPosition(), glm::vec2{ xPos, yPos }) <= node->getSize().x)
-            {
-                m_rightClickSelectedNode = node;
-                std::cout << "Right click. Selected node. id:" << node->getInternalID() << ", pos: " 
-                          << node->getPosition().x << ", " << node->getPosition().y << "\n"; 
-                break;
-            }
+            m_rightClickSelectedNode = node;
+            std::cout << "Right click. Selected node. id:" << node->getInternalID() << ", pos: " 
+                      << node->getPosition().x << ", " << node->getPosition().y << "\n"; 
         }
     }
 }
 
+// Chord length on the unit sphere grows with the great-circle distance, so the nearest point in 3D is the nearest on the globe.
+static KdTree<3>::Point toUnitSphere(GeoCoordinate coordinate)
+{
+    constexpr double kDegreesToRadians = 3.14159265358979323846 / 180.0;
+    double latitude = coordinate.latitude * kDegreesToRadians;
+    double longitude = coordinate.longitude * kDegreesToRadians;
+    return { std::cos(latitude) * std::cos(longitude), std::cos(latitude) * std::sin(longitude), std::sin(latitude) };
+}
+
 static double minLatitude  = std::numeric_limits<double>::max();
 static double maxLatitude  = std::numeric_limits<double>::lowest();
 static double minLongitude = std::numeric_limits<double>::max();
@@ -97,8 +103,12 @@ void MapEditor::loadFromFile(const std::string& filePath)
 {
     m_graphData.clear();
     m_leftClickSelectedNode = nullptr;
+    m_rightClickSelectedNode = nullptr;
+    m_screenTree.clear();
+    m_geoTree.clear();
     m_renderer.clearEdgeBatch();
     m_renderer.clearNodeBatch();
+    m_renderer.setHighlightedEdges({});
 
     pugi::xml_document doc;
     if (!doc.load_file(filePath.c_str()))
@@ -125,6 +135,12 @@ void MapEditor::loadFromFile(const std::string& filePath)
 
     std::vector<GraphNode*> nodes;
     nodes.reserve(nodeCount);
+    std::vector<GeoCoordinate> geoCoordinates;
+    geoCoordinates.reserve(nodeCount);
+    std::vector<KdTree<2>::Point> screenPoints;
+    screenPoints.reserve(nodeCount);
+    std::vector<KdTree<3>::Point> geoPoints;
+    geoPoints.reserve(nodeCount);
 
     int width, height;
     glfwGetWindowSize(glfwGetCurrentContext(), &width, &height);
@@ -136,9 +152,15 @@ void MapEditor::loadFromFile(const std::string& filePath)
 
         glm::vec2 coordinates{convertToScreenCoordinates(latitude, longitude, width, height)};
         nodes.push_back(new GraphNode{coordinates, "", static_cast<unsigned int>(nodes.size()), glm::vec2{1.0f, 1.0f}});
+        geoCoordinates.push_back({latitude, longitude});
+        screenPoints.push_back({coordinates.x, coordinates.y});
+        geoPoints.push_back(toUnitSphere({latitude, longitude}));
     }
 
     m_graphData.getNodes() = std::move(nodes);
+    m_graphData.setGeoCoordinates(std::move(geoCoordinates));
+    m_screenTree.build(std::move(screenPoints));
+    m_geoTree.build(std::move(geoPoints));
     std::cout << "done with the nodes\n";
 
     std::vector<Edge> edges;
@@ -158,6 +180,19 @@ void MapEditor::loadFromFile(const std::string& filePath)
     std::cout << "done with the edges\n";
     m_graphData.updateAdjacencyList();
 
+    if (!m_graphData.hasGeoHeuristic())
+    {
+        std::cout << "Coordinates can't guide A*, map queries fall back to bidirectional Dijkstra\n";
+    }
+
+    m_mapFilePath = filePath;
+    m_trafficApplied = false;
+    m_freeFlowWeights.clear();
+    for (const auto& edge : m_graphData.getEdges())
+    {
+        m_freeFlowWeights.push_back(edge.getWeight());
+    }
+
     std::cout << "done\n";
 }
 
@@ -174,16 +209,351 @@ void MapEditor::findMinDistance()
         return;
     }
 
-    std::vector<unsigned int> minPath{m_graphData.dijkstraMinimumCost(m_leftClickSelectedNode, m_rightClickSelectedNode)};
+    unsigned int sourceNodeID = m_leftClickSelectedNode->getInternalID();
+    unsigned int targetNodeID = m_rightClickSelectedNode->getInternalID();
+
+    PathQueryResult minPath;
+    const unsigned long long graphVersion = m_graphData.getVersion();
+    if (const PathQueryResult* cachedPath = m_routeCache.find(sourceNodeID, targetNodeID, graphVersion))
+    {
+        minPath = *cachedPath;
+    }
+    else
+    {
+        prepareRoutingIndex(m_routingAlgorithm);
+        switch (m_routingAlgorithm)
+        {
+        case RoutingAlgorithm::dijkstra:              minPath = m_graphData.shortestPath(sourceNodeID, targetNodeID); break;
+        case RoutingAlgorithm::bidirectionalDijkstra: minPath = m_graphData.bidirectionalShortestPath(sourceNodeID, targetNodeID); break;
+        case RoutingAlgorithm::aStar:                 minPath = m_graphData.aStarShortestPath(sourceNodeID, targetNodeID); break;
+        case RoutingAlgorithm::landmarks:             minPath = m_graphData.landmarkShortestPath(sourceNodeID, targetNodeID); break;
+        case RoutingAlgorithm::contractionHierarchy:  minPath = m_graphData.contractionHierarchyShortestPath(sourceNodeID, targetNodeID); break;
+        case RoutingAlgorithm::customizableHierarchy: minPath = m_graphData.customizableShortestPath(sourceNodeID, targetNodeID); break;
+        }
+        m_routeCache.insert(sourceNodeID, targetNodeID, graphVersion, minPath);
+    }
+    std::cout << "Route cache: " << m_routeCache.getHits() << " hits, " << m_routeCache.getMisses() << " misses\n";
+
+    if (!minPath.isReachable())
+    {
+        std::cout << "No path between the selected nodes\n";
+        return;
+    }
+    std::cout << "Distance: " << minPath.distance << ", settled nodes: " << minPath.settledNodes << "\n";
+
+    for (unsigned int edgeIndex : minPath.edges)
+    {
+        Edge& edge{m_graphData.getEdgesRef()[edgeIndex]};
+        edge.setColor(glm::vec4{0.0f, 1.0f, 0.0f, 1.0f});
+        edge.setDepth(0.5f);
+    }
+}
 
-    for (int index = 0; index < minPath.size() - 1; ++index)
+void MapEditor::findAlternativeRoutes(unsigned int routeCount)
+{
+    if (!m_leftClickSelectedNode || !m_rightClickSelectedNode)
     {
-        auto edge{m_graphData.getEdge(minPath[index], minPath[index + 1])};
-        edge->setColor(glm::vec4{0.0f, 1.0f, 0.0f, 1.0f});
-        edge->setDepth(0.5f);
+        std::cout << "Select a start and an end position\n";
+        return;
+    }
+
+    static const glm::vec4 routeColors[]{
+        { 0.0f, 1.0f, 0.0f, 1.0f }, { 0.0f, 0.6f, 1.0f, 1.0f }, { 1.0f, 0.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 0.0f, 1.0f },
+        { 0.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 0.4f, 0.4f, 1.0f }, { 0.6f, 0.4f, 1.0f, 1.0f }, { 1.0f, 0.6f, 0.0f, 1.0f }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PathQueryResult> routes = m_graphData.kShortestPaths(m_leftClickSelectedNode->getInternalID(), m_rightClickSelectedNode->getInternalID(), routeCount);
+    std::cout << "Found " << routes.size() << " routes in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms\n";
+
+    // the best route is colored last so it stays visible where routes overlap
+    for (unsigned int routeIndex = static_cast<unsigned int>(routes.size()); routeIndex-- > 0;)
+    {
+        std::cout << "Route " << routeIndex + 1 << ": " << routes[routeIndex].distance << "\n";
+        for (unsigned int edgeIndex : routes[routeIndex].edges)
+        {
+            Edge& edge{m_graphData.getEdgesRef()[edgeIndex]};
+            edge.setColor(routeColors[routeIndex % std::size(routeColors)]);
+            edge.setDepth(0.5f);
+        }
     }
 }
 
+void MapEditor::reportRoutingBenchmark(unsigned int sampleQueries)
+{
+    const unsigned int nodeCount = static_cast<unsigned int>(m_graphData.getSize());
+    if (nodeCount == 0)
+    {
+        std::cout << "No map loaded\n";
+        return;
+    }
+
+    prepareRoutingIndex(RoutingAlgorithm::contractionHierarchy);
+    if (!m_graphData.hasHubLabels())
+    {
+        auto start = std::chrono::steady_clock::now();
+        m_graphData.buildHubLabels();
+        std::cout << "Built hub labels in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
+    }
+
+    std::mt19937 generator{ 42 };
+    std::uniform_int_distribution<unsigned int> distribution{ 0, nodeCount - 1 };
+    std::vector<std::pair<unsigned int, unsigned int>> queries(sampleQueries);
+    for (auto& [sourceNodeID, targetNodeID] : queries)
+    {
+        sourceNodeID = distribution(generator);
+        targetNodeID = distribution(generator);
+    }
+
+    QueuePolicy queuePolicy = m_graphData.selectFastestQueuePolicy();
+    std::cout << "Using " << ShortestPathEngine::getQueuePolicyName(queuePolicy) << " for shortest paths\n";
+
+    std::vector<unsigned int> dijkstraDistances, hierarchyDistances, hubLabelDistances;
+    auto measure = [&](std::vector<unsigned int>& distances, auto&& query)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& [sourceNodeID, targetNodeID] : queries)
+        {
+            distances.push_back(query(sourceNodeID, targetNodeID));
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / std::max(1u, sampleQueries);
+    };
+
+    double dijkstraLatency = measure(dijkstraDistances, [&](unsigned int s, unsigned int t) { return m_graphData.shortestPath(s, t).distance; });
+    double hierarchyLatency = measure(hierarchyDistances, [&](unsigned int s, unsigned int t) { return m_graphData.contractionHierarchyShortestPath(s, t).distance; });
+    double hubLabelLatency = measure(hubLabelDistances, [&](unsigned int s, unsigned int t) { return m_graphData.hubLabelDistance(s, t); });
+
+    if (dijkstraDistances != hierarchyDistances || dijkstraDistances != hubLabelDistances)
+    {
+        std::cout << "Distances differ between the routing methods\n";
+    }
+
+    unsigned int oneToAllSource = distribution(generator);
+    std::vector<unsigned int> sequentialDistances, parallelDistances, parentNodes;
+    auto start = std::chrono::steady_clock::now();
+    ShortestPathEngine::computeDistances(m_graphData.getCompactGraph(), oneToAllSource, false, sequentialDistances);
+    double sequentialTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    m_graphData.deltaSteppingDistances(oneToAllSource, parallelDistances, parentNodes);
+    double parallelTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    BatchQueryResult batch = m_graphData.batchShortestPaths(queries);
+    if (batch.distances != dijkstraDistances)
+    {
+        std::cout << "Batch distances differ from Dijkstra\n";
+    }
+
+    start = std::chrono::steady_clock::now();
+    m_graphData.oneToAllDistances(oneToAllSource, parallelDistances);
+    double sweepTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (sequentialDistances != parallelDistances)
+    {
+        std::cout << "Delta-stepping or PHAST distances differ from Dijkstra\n";
+    }
+
+    const HubLabels& hubLabels = m_graphData.getHubLabels();
+    std::cout << "Routing report over " << sampleQueries << " random queries\n"
+              << "Dijkstra:              " << dijkstraLatency << " us, " << m_graphData.getCompactGraph().getMemoryUsage() / 1024 << " KiB\n"
+              << "Contraction hierarchy: " << hierarchyLatency << " us, " << m_graphData.getContractionHierarchy().getMemoryUsage() / 1024 << " KiB\n"
+              << "Hub labels:            " << hubLabelLatency << " us, " << hubLabels.getMemoryUsage() / 1024 << " KiB, "
+              << hubLabels.getAverageLabelSize() << " hubs per label\n"
+              << "One-to-all Dijkstra:   " << sequentialTime << " ms, delta-stepping " << parallelTime << " ms on "
+              << getParallelThreadCount() << " threads (bucket width " << DeltaStepping::suggestBucketWidth(m_graphData.getCompactGraph()) << "), PHAST "
+              << sweepTime << " ms\n"
+              << "Batch queries:         " << batch.getQueriesPerSecond() << " queries/s on " << getParallelThreadCount() << " threads\n";
+}
+
+void MapEditor::applyTrafficUpdate(float affectedShare)
+{
+    if (m_freeFlowWeights.size() != m_graphData.getEdges().size())
+    {
+        std::cout << "No map loaded\n";
+        return;
+    }
+
+    std::mt19937 generator{ std::random_device{}() };
+    std::bernoulli_distribution affected{ affectedShare };
+    std::uniform_real_distribution<float> slowdown{ 1.0f, 3.0f };
+    std::vector<std::pair<unsigned int, int>> edgeWeights;
+    for (unsigned int edgeIndex = 0; edgeIndex < m_freeFlowWeights.size(); ++edgeIndex)
+    {
+        if (affected(generator))
+        {
+            edgeWeights.push_back({ edgeIndex, static_cast<int>(m_freeFlowWeights[edgeIndex] * slowdown(generator)) });
+        }
+    }
+
+    // the contraction hierarchy can't follow new weights, so hierarchy queries switch to the customizable one
+    if (m_routingAlgorithm == RoutingAlgorithm::contractionHierarchy || m_routingAlgorithm == RoutingAlgorithm::customizableHierarchy)
+    {
+        prepareRoutingIndex(RoutingAlgorithm::customizableHierarchy);
+    }
+    m_trafficApplied = true;
+
+    auto start = std::chrono::steady_clock::now();
+    m_graphData.setEdgeWeights(edgeWeights);
+    std::cout << "Applied " << edgeWeights.size() << " weight changes in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms\n";
+}
+
+void MapEditor::showIsochrone(unsigned int maxDistance)
+{
+    if (!m_leftClickSelectedNode)
+    {
+        std::cout << "No start position selected\n";
+        return;
+    }
+
+    std::vector<std::pair<unsigned int, unsigned int>> reachedNodes;
+    m_graphData.nodesWithinDistance(m_leftClickSelectedNode->getInternalID(), maxDistance, reachedNodes);
+
+    std::vector<bool> reached(m_graphData.getSize(), false);
+    for (const auto& [nodeID, distance] : reachedNodes)
+    {
+        reached[nodeID] = true;
+    }
+
+    std::vector<const Edge*> regionEdges;
+    for (const auto& edge : m_graphData.getEdges())
+    {
+        if (reached[edge.getStartNode()->getInternalID()] && reached[edge.getEndNode()->getInternalID()])
+        {
+            regionEdges.push_back(&edge);
+        }
+    }
+    m_renderer.setHighlightedEdges(regionEdges);
+    std::cout << reachedNodes.size() << " nodes within " << maxDistance << "\n";
+}
+
+void MapEditor::exportDistanceTable(unsigned int endpointCount, const std::string& filePath)
+{
+    const unsigned int nodeCount = static_cast<unsigned int>(m_graphData.getSize());
+    if (nodeCount == 0)
+    {
+        std::cout << "No map loaded\n";
+        return;
+    }
+
+    std::mt19937 generator{ 42 };
+    std::uniform_int_distribution<unsigned int> distribution{ 0, nodeCount - 1 };
+    std::vector<unsigned int> sourceNodeIDs(endpointCount), targetNodeIDs(endpointCount);
+    for (unsigned int index = 0; index < endpointCount; ++index)
+    {
+        sourceNodeIDs[index] = distribution(generator);
+        targetNodeIDs[index] = distribution(generator);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    DistanceTable table = m_graphData.distanceTable(sourceNodeIDs, targetNodeIDs);
+    std::cout << "Computed a " << endpointCount << "x" << endpointCount << " distance table in "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
+    if (table.save(filePath))
+    {
+        std::cout << "Saved the distance table to " << filePath << "\n";
+    }
+}
+
+void MapEditor::routeBetweenCoordinates(GeoCoordinate start, GeoCoordinate end)
+{
+    unsigned int sourceNodeID = findNearestNode(start);
+    unsigned int targetNodeID = findNearestNode(end);
+    if (sourceNodeID == KdTree<3>::kNone || targetNodeID == KdTree<3>::kNone)
+    {
+        std::cout << "No map loaded\n";
+        return;
+    }
+
+    m_leftClickSelectedNode = m_graphData.getNode(sourceNodeID);
+    m_rightClickSelectedNode = m_graphData.getNode(targetNodeID);
+    std::cout << "Routing from node " << sourceNodeID << " to node " << targetNodeID << "\n";
+    findMinDistance();
+}
+
+void MapEditor::setRoutingAlgorithm(RoutingAlgorithm algorithm)
+{
+    m_routingAlgorithm = algorithm;
+    m_routeCache.clear();
+    prepareRoutingIndex(algorithm);
+}
+
+// Indexes are built the first time a routing method needs them. Files next to the map cache them for the free-flow
+// weights only, so they are neither loaded nor written once traffic has changed the weights.
+void MapEditor::prepareRoutingIndex(RoutingAlgorithm algorithm)
+{
+    if (m_graphData.getSize() == 0)
+    {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    switch (algorithm)
+    {
+    case RoutingAlgorithm::landmarks:
+    {
+        if (m_graphData.hasLandmarks())
+        {
+            return;
+        }
+
+        std::string landmarksFilePath{m_mapFilePath + ".landmarks"};
+        if (!m_trafficApplied && m_graphData.loadLandmarks(landmarksFilePath))
+        {
+            std::cout << "Loaded landmarks from " << landmarksFilePath << "\n";
+            return;
+        }
+        m_graphData.buildLandmarks(kLandmarkCount, LandmarkSelection::avoid);
+        std::cout << "Built " << kLandmarkCount << " landmarks in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
+        if (!m_trafficApplied && m_graphData.saveLandmarks(landmarksFilePath))
+        {
+            std::cout << "Saved landmarks to " << landmarksFilePath << "\n";
+        }
+        break;
+    }
+    case RoutingAlgorithm::contractionHierarchy:
+    {
+        // the contraction order only fits the free-flow weights, after a traffic update the customizable hierarchy answers
+        if (m_trafficApplied)
+        {
+            prepareRoutingIndex(RoutingAlgorithm::customizableHierarchy);
+            return;
+        }
+        if (m_graphData.hasContractionHierarchy())
+        {
+            return;
+        }
+
+        std::string hierarchyFilePath{m_mapFilePath + ".ch"};
+        if (m_graphData.loadContractionHierarchy(hierarchyFilePath))
+        {
+            std::cout << "Loaded contraction hierarchy from " << hierarchyFilePath << "\n";
+            return;
+        }
+        m_graphData.buildContractionHierarchy();
+        std::cout << "Contracted the map in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s, "
+                  << m_graphData.getContractionHierarchy().getShortcutCount() << " shortcuts\n";
+        if (m_graphData.saveContractionHierarchy(hierarchyFilePath))
+        {
+            std::cout << "Saved contraction hierarchy to " << hierarchyFilePath << "\n";
+        }
+        break;
+    }
+    case RoutingAlgorithm::customizableHierarchy:
+        if (m_graphData.hasCustomizableHierarchy())
+        {
+            return;
+        }
+        m_graphData.buildCustomizableHierarchy();
+        std::cout << "Built the customizable hierarchy in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s, "
+                  << m_graphData.getCustomizableHierarchy().getArcCount() << " arcs\n";
+        break;
+    default:
+        break;
+    }
+}
+
+RoutingAlgorithm MapEditor::getRoutingAlgorithm() const
+{
+    return m_routingAlgorithm;
+}
+
 GraphData& MapEditor::getGraphData()
 {
     return m_graphData;
@@ -211,17 +581,33 @@ glm::vec2 MapEditor::convertToScreenCoordinates(double latitude, double longitud
 
 void MapEditor::checkNodeSelect(glm::vec2 position)
 {
-    for (auto& node : m_graphData.getNodes())
+    if (GraphNode* node = findNodeAt(position))
     {
-        if (glm::distance(node->getPosition(), position) >= node->getSize().x)
-        {
-            continue;
-        }
-
         LOG("node selected\n");
         m_leftClickSelectedNode = node;
         edgeStart = node;
         return;
     }
     m_leftClickSelectedNode = nullptr;
+}
+
+GraphNode* MapEditor::findNodeAt(glm::vec2 position)
+{
+    unsigned int nodeID = m_screenTree.nearest({ position.x, position.y });
+    if (nodeID == KdTree<2>::kNone)
+    {
+        return nullptr;
+    }
+
+    GraphNode* node = m_graphData.getNodes()[nodeID];
+    if (glm::distance(node->getPosition(), position) > kSelectionRadius)
+    {
+        return nullptr;
+    }
+    return node;
+}
+
+unsigned int MapEditor::findNearestNode(GeoCoordinate coordinate) const
+{
+    return m_geoTree.nearest(toUnitSphere(coordinate));
 }
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "MinCostFlow.h"
+#include "ShortestPathEngine.h"
+#include <algorithm>
+#include <numeric>
+
+static constexpr unsigned int kNoArc = 0xFFFFFFFF;
+
+MinCostFlow::MinCostFlow()
+    : m_nodeCount{ 0 }, m_edgeCount{ 0 }, m_hasNegativeCosts{ false }, m_offsets{}, m_heads{}, m_capacities{}, m_costs{}
+    , m_reverseArcs{}, m_edgeArcs{}, m_residual{}, m_potentials{}, m_distances{}, m_parentArcs{}, m_settled{}, m_queue{}
+{}
+
+void MinCostFlow::build(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented, const std::vector<int>& costs)
+{
+    m_nodeCount = nodeCount;
+    m_edgeCount = static_cast<unsigned int>(edges.size());
+    m_hasNegativeCosts = std::any_of(costs.begin(), costs.end(), [](int cost) { return cost < 0; });
+
+    // every directed use of an edge is a forward arc paired with a zero capacity reverse arc
+    auto forEachUse = [&](auto&& function)
+    {
+        for (unsigned int edgeIndex = 0; edgeIndex < m_edgeCount; ++edgeIndex)
+        {
+            unsigned int startNodeID = edges[edgeIndex].getStartNode()->getInternalID();
+            unsigned int endNodeID = edges[edgeIndex].getEndNode()->getInternalID();
+            function(edgeIndex, 0u, startNodeID, endNodeID);
+            if (!oriented)
+            {
+                function(edgeIndex, 1u, endNodeID, startNodeID);
+            }
+        }
+    };
+
+    m_offsets.assign(nodeCount + 1, 0);
+    forEachUse([&](unsigned int, unsigned int, unsigned int tailNodeID, unsigned int headNodeID)
+    {
+        ++m_offsets[tailNodeID + 1];
+        ++m_offsets[headNodeID + 1];
+    });
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+    const unsigned int arcCount = m_offsets[nodeCount];
+    m_heads.resize(arcCount);
+    m_capacities.resize(arcCount);
+    m_costs.resize(arcCount);
+    m_reverseArcs.resize(arcCount);
+    m_edgeArcs.assign(2 * static_cast<std::size_t>(m_edgeCount), kNoArc);
+
+    std::vector<unsigned int> nextArc(m_offsets.begin(), m_offsets.end() - 1);
+    forEachUse([&](unsigned int edgeIndex, unsigned int direction, unsigned int tailNodeID, unsigned int headNodeID)
+    {
+        unsigned int forwardArc = nextArc[tailNodeID]++;
+        unsigned int reverseArc = nextArc[headNodeID]++;
+        m_heads[forwardArc] = headNodeID;
+        m_capacities[forwardArc] = std::max(0, edges[edgeIndex].getWeight());
+        m_costs[forwardArc] = costs[edgeIndex];
+        m_reverseArcs[forwardArc] = reverseArc;
+        m_heads[reverseArc] = tailNodeID;
+        m_capacities[reverseArc] = 0;
+        m_costs[reverseArc] = -costs[edgeIndex];
+        m_reverseArcs[reverseArc] = forwardArc;
+        m_edgeArcs[2 * static_cast<std::size_t>(edgeIndex) + direction] = forwardArc;
+    });
+}
+
+MinCostFlowResult MinCostFlow::solve(unsigned int sourceNodeID, unsigned int sinkNodeID, long long flowLimit)
+{
+    MinCostFlowResult result;
+    result.edgeFlows.assign(m_edgeCount, 0);
+    m_residual = m_capacities;
+    if (sourceNodeID >= m_nodeCount || sinkNodeID >= m_nodeCount || sourceNodeID == sinkNodeID)
+    {
+        return result;
+    }
+
+    if (!initializePotentials(sourceNodeID))
+    {
+        result.feasible = false;
+        return result;
+    }
+
+    while (result.flow < flowLimit && findShortestPath(sourceNodeID, sinkNodeID))
+    {
+        long long pathFlow = flowLimit - result.flow;
+        for (unsigned int nodeID = sinkNodeID; nodeID != sourceNodeID; nodeID = m_heads[m_reverseArcs[m_parentArcs[nodeID]]])
+        {
+            pathFlow = std::min<long long>(pathFlow, m_residual[m_parentArcs[nodeID]]);
+        }
+
+        for (unsigned int nodeID = sinkNodeID; nodeID != sourceNodeID; nodeID = m_heads[m_reverseArcs[m_parentArcs[nodeID]]])
+        {
+            unsigned int arc = m_parentArcs[nodeID];
+            m_residual[arc] -= static_cast<int>(pathFlow);
+            m_residual[m_reverseArcs[arc]] += static_cast<int>(pathFlow);
+            result.cost += pathFlow * m_costs[arc];
+        }
+        result.flow += pathFlow;
+        ++result.augmentations;
+    }
+
+    for (unsigned int edgeIndex = 0; edgeIndex < m_edgeCount; ++edgeIndex)
+    {
+        unsigned int forwardArc = m_edgeArcs[2 * static_cast<std::size_t>(edgeIndex)];
+        unsigned int backwardArc = m_edgeArcs[2 * static_cast<std::size_t>(edgeIndex) + 1];
+        result.edgeFlows[edgeIndex] = m_capacities[forwardArc] - m_residual[forwardArc];
+        if (backwardArc != kNoArc)
+        {
+            result.edgeFlows[edgeIndex] -= m_capacities[backwardArc] - m_residual[backwardArc];
+        }
+    }
+    return result;
+}
+
+// Without negative costs zero potentials already make every reduced cost non-negative. Otherwise Bellman-Ford over the
+// arcs with capacity gives distances from the source; nodes it can't reach never take part in an augmentation.
+bool MinCostFlow::initializePotentials(unsigned int sourceNodeID)
+{
+    m_potentials.assign(m_nodeCount, 0);
+    if (!m_hasNegativeCosts)
+    {
+        return true;
+    }
+
+    constexpr long long kUnreached = std::numeric_limits<long long>::max();
+    std::fill(m_potentials.begin(), m_potentials.end(), kUnreached);
+    m_potentials[sourceNodeID] = 0;
+    for (unsigned int round = 0; round < m_nodeCount; ++round)
+    {
+        bool changed = false;
+        for (unsigned int nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+        {
+            if (m_potentials[nodeID] == kUnreached)
+            {
+                continue;
+            }
+            for (unsigned int arc = m_offsets[nodeID]; arc < m_offsets[nodeID + 1]; ++arc)
+            {
+                if (m_residual[arc] > 0 && m_potentials[nodeID] + m_costs[arc] < m_potentials[m_heads[arc]])
+                {
+                    m_potentials[m_heads[arc]] = m_potentials[nodeID] + m_costs[arc];
+                    changed = true;
+                }
+            }
+        }
+
+        if (!changed)
+        {
+            std::replace(m_potentials.begin(), m_potentials.end(), kUnreached, 0ll);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Dijkstra on reduced costs, stopped once the sink is settled. Nodes left unsettled move their potential by the sink
+// distance, which is at most their own, so reduced costs stay non-negative for the next round.
+bool MinCostFlow::findShortestPath(unsigned int sourceNodeID, unsigned int sinkNodeID)
+{
+    m_distances.assign(m_nodeCount, PathQueryResult::kUnreachable);
+    m_parentArcs.assign(m_nodeCount, kNoArc);
+    m_settled.assign(m_nodeCount, false);
+    m_queue.reset(m_nodeCount, 0);
+
+    m_distances[sourceNodeID] = 0;
+    m_queue.push(sourceNodeID, 0);
+    while (!m_queue.empty())
+    {
+        auto [distance, nodeID] = m_queue.pop();
+        if (m_settled[nodeID])
+        {
+            continue;
+        }
+        m_settled[nodeID] = true;
+        if (nodeID == sinkNodeID)
+        {
+            break;
+        }
+
+        for (unsigned int arc = m_offsets[nodeID]; arc < m_offsets[nodeID + 1]; ++arc)
+        {
+            unsigned int adjNodeID = m_heads[arc];
+            if (m_residual[arc] <= 0 || m_settled[adjNodeID])
+            {
+                continue;
+            }
+
+            long long reducedCost = m_costs[arc] + m_potentials[nodeID] - m_potentials[adjNodeID];
+            unsigned int adjDistance = distance + static_cast<unsigned int>(reducedCost);
+            if (adjDistance < m_distances[adjNodeID])
+            {
+                m_distances[adjNodeID] = adjDistance;
+                m_parentArcs[adjNodeID] = arc;
+                m_queue.push(adjNodeID, adjDistance);
+            }
+        }
+    }
+
+    if (!m_settled[sinkNodeID])
+    {
+        return false;
+    }
+
+    const unsigned int sinkDistance = m_distances[sinkNodeID];
+    for (unsigned int nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+    {
+        m_potentials[nodeID] += m_settled[nodeID] ? m_distances[nodeID] : sinkDistance;
+    }
+    return true;
+}
@@ -0,0 +1,304 @@
+#include "ReachabilityIndex.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+ReachabilityIndex::ReachabilityIndex()
+    : m_nodeCount{ 0 }, m_componentCount{ 0 }, m_traversalCount{ 0 }, m_components{}, m_offsets{}, m_targets{}, m_intervals{}
+    , m_treeStarts{}, m_epochs{}, m_stack{}, m_epoch{ 0 }, m_fallbackSearches{ 0 }
+{}
+
+void ReachabilityIndex::build(const CompactGraph& graph, unsigned int traversalCount)
+{
+    clear();
+    m_nodeCount = graph.getNodeCount();
+    m_traversalCount = std::max(1u, traversalCount);
+
+    computeComponents(graph);
+    buildCondensation(graph);
+
+    m_intervals.resize(static_cast<std::size_t>(m_componentCount) * m_traversalCount);
+    m_treeStarts.resize(m_componentCount);
+    for (unsigned int traversal = 0; traversal < m_traversalCount; ++traversal)
+    {
+        labelTraversal(traversal, traversal + 1);
+    }
+
+    m_epochs.assign(m_componentCount, 0);
+}
+
+void ReachabilityIndex::clear()
+{
+    m_nodeCount = 0;
+    m_componentCount = 0;
+    m_traversalCount = 0;
+    m_components.clear();
+    m_offsets.clear();
+    m_targets.clear();
+    m_intervals.clear();
+    m_treeStarts.clear();
+    m_epochs.clear();
+    m_stack.clear();
+    m_epoch = 0;
+    m_fallbackSearches = 0;
+}
+
+bool ReachabilityIndex::isBuilt() const
+{
+    return m_traversalCount > 0;
+}
+
+bool ReachabilityIndex::canReach(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    const unsigned int sourceComponent = m_components[sourceNodeID];
+    const unsigned int targetComponent = m_components[targetNodeID];
+    if (sourceComponent == targetComponent)
+    {
+        return true;
+    }
+    if (!mayReach(sourceComponent, targetComponent))
+    {
+        return false;
+    }
+
+    const unsigned int targetPost = m_intervals[static_cast<std::size_t>(targetComponent) * m_traversalCount].post;
+    if (m_treeStarts[sourceComponent] <= targetPost && targetPost <= m_intervals[static_cast<std::size_t>(sourceComponent) * m_traversalCount].post)
+    {
+        return true;
+    }
+
+    ++m_fallbackSearches;
+    if (++m_epoch == 0)
+    {
+        std::fill(m_epochs.begin(), m_epochs.end(), 0);
+        m_epoch = 1;
+    }
+
+    m_stack.assign(1, sourceComponent);
+    m_epochs[sourceComponent] = m_epoch;
+    while (!m_stack.empty())
+    {
+        unsigned int component = m_stack.back();
+        m_stack.pop_back();
+
+        for (unsigned int arc = m_offsets[component]; arc < m_offsets[component + 1]; ++arc)
+        {
+            unsigned int adjComponent = m_targets[arc];
+            if (adjComponent == targetComponent)
+            {
+                return true;
+            }
+            if (m_epochs[adjComponent] != m_epoch && mayReach(adjComponent, targetComponent))
+            {
+                m_epochs[adjComponent] = m_epoch;
+                m_stack.push_back(adjComponent);
+            }
+        }
+    }
+    return false;
+}
+
+unsigned int ReachabilityIndex::getComponent(unsigned int nodeID) const
+{
+    return m_components[nodeID];
+}
+
+unsigned int ReachabilityIndex::getComponentCount() const
+{
+    return m_componentCount;
+}
+
+unsigned int ReachabilityIndex::getFallbackSearches() const
+{
+    return m_fallbackSearches;
+}
+
+// Iterative Tarjan. Components are numbered as they complete, so every arc of the condensation goes from a higher
+// number to a lower one.
+void ReachabilityIndex::computeComponents(const CompactGraph& graph)
+{
+    constexpr unsigned int kUnvisited = 0xFFFFFFFF;
+
+    m_components.assign(m_nodeCount, kUnvisited);
+    std::vector<unsigned int> discovery(m_nodeCount, kUnvisited);
+    std::vector<unsigned int> lowLink(m_nodeCount, 0);
+    std::vector<unsigned int> componentStack;
+    std::vector<std::pair<unsigned int, unsigned int>> callStack;
+    unsigned int time = 0;
+
+    for (unsigned int rootNodeID = 0; rootNodeID < m_nodeCount; ++rootNodeID)
+    {
+        if (discovery[rootNodeID] != kUnvisited)
+        {
+            continue;
+        }
+
+        discovery[rootNodeID] = lowLink[rootNodeID] = time++;
+        componentStack.push_back(rootNodeID);
+        callStack.push_back({ rootNodeID, 0 });
+        while (!callStack.empty())
+        {
+            auto& [nodeID, nextNeighbor] = callStack.back();
+            auto neighbors = graph.getOutNeighbors(nodeID);
+            if (nextNeighbor < neighbors.size())
+            {
+                unsigned int adjNodeID = neighbors[nextNeighbor++];
+                if (discovery[adjNodeID] == kUnvisited)
+                {
+                    discovery[adjNodeID] = lowLink[adjNodeID] = time++;
+                    componentStack.push_back(adjNodeID);
+                    callStack.push_back({ adjNodeID, 0 });
+                }
+                else if (m_components[adjNodeID] == kUnvisited)
+                {
+                    lowLink[nodeID] = std::min(lowLink[nodeID], discovery[adjNodeID]);
+                }
+                continue;
+            }
+
+            unsigned int finishedNodeID = nodeID;
+            callStack.pop_back();
+            if (!callStack.empty())
+            {
+                unsigned int parentNodeID = callStack.back().first;
+                lowLink[parentNodeID] = std::min(lowLink[parentNodeID], lowLink[finishedNodeID]);
+            }
+
+            if (lowLink[finishedNodeID] == discovery[finishedNodeID])
+            {
+                unsigned int memberNodeID;
+                do
+                {
+                    memberNodeID = componentStack.back();
+                    componentStack.pop_back();
+                    m_components[memberNodeID] = m_componentCount;
+                } while (memberNodeID != finishedNodeID);
+                ++m_componentCount;
+            }
+        }
+    }
+}
+
+void ReachabilityIndex::buildCondensation(const CompactGraph& graph)
+{
+    std::vector<std::pair<unsigned int, unsigned int>> arcs;
+    for (unsigned int nodeID = 0; nodeID < m_nodeCount; ++nodeID)
+    {
+        for (unsigned int adjNodeID : graph.getOutNeighbors(nodeID))
+        {
+            if (m_components[nodeID] != m_components[adjNodeID])
+            {
+                arcs.push_back({ m_components[nodeID], m_components[adjNodeID] });
+            }
+        }
+    }
+    std::sort(arcs.begin(), arcs.end());
+    arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+    m_offsets.assign(m_componentCount + 1, 0);
+    m_targets.resize(arcs.size());
+    for (unsigned int arc = 0; arc < arcs.size(); ++arc)
+    {
+        ++m_offsets[arcs[arc].first + 1];
+        m_targets[arc] = arcs[arc].second;
+    }
+    std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+}
+
+// Post-order DFS over the condensation, roots and children taken in a shuffled order. low is the smallest post-order
+// number among the component and everything it reaches, which the children already carry when it finishes.
+void ReachabilityIndex::labelTraversal(unsigned int traversal, unsigned int seed)
+{
+    std::mt19937 generator{ seed };
+    std::vector<unsigned int> roots;
+    std::vector<bool> hasParent(m_componentCount, false);
+    for (unsigned int adjComponent : m_targets)
+    {
+        hasParent[adjComponent] = true;
+    }
+    for (unsigned int component = 0; component < m_componentCount; ++component)
+    {
+        if (!hasParent[component])
+        {
+            roots.push_back(component);
+        }
+    }
+    std::shuffle(roots.begin(), roots.end(), generator);
+
+    std::vector<unsigned int> rotations(m_componentCount);
+    for (unsigned int component = 0; component < m_componentCount; ++component)
+    {
+        unsigned int degree = m_offsets[component + 1] - m_offsets[component];
+        rotations[component] = degree > 1 ? generator() % degree : 0;
+    }
+
+    std::vector<bool> visited(m_componentCount, false);
+    std::vector<std::pair<unsigned int, unsigned int>> callStack;
+    unsigned int post = 0;
+    auto interval = [&](unsigned int component) -> Interval& { return m_intervals[static_cast<std::size_t>(component) * m_traversalCount + traversal]; };
+
+    for (unsigned int rootComponent : roots)
+    {
+        visited[rootComponent] = true;
+        interval(rootComponent).low = 0xFFFFFFFF;
+        if (traversal == 0)
+        {
+            m_treeStarts[rootComponent] = post;
+        }
+        callStack.push_back({ rootComponent, 0 });
+        while (!callStack.empty())
+        {
+            auto& [component, nextChild] = callStack.back();
+            unsigned int degree = m_offsets[component + 1] - m_offsets[component];
+            if (nextChild < degree)
+            {
+                unsigned int adjComponent = m_targets[m_offsets[component] + (nextChild++ + rotations[component]) % degree];
+                if (!visited[adjComponent])
+                {
+                    visited[adjComponent] = true;
+                    interval(adjComponent).low = 0xFFFFFFFF;
+                    if (traversal == 0)
+                    {
+                        m_treeStarts[adjComponent] = post;
+                    }
+                    callStack.push_back({ adjComponent, 0 });
+                }
+                else
+                {
+                    interval(component).low = std::min(interval(component).low, interval(adjComponent).low);
+                }
+                continue;
+            }
+
+            unsigned int finishedComponent = component;
+            callStack.pop_back();
+            interval(finishedComponent).post = post;
+            interval(finishedComponent).low = std::min(interval(finishedComponent).low, post);
+            ++post;
+            if (!callStack.empty())
+            {
+                unsigned int parentComponent = callStack.back().first;
+                interval(parentComponent).low = std::min(interval(parentComponent).low, interval(finishedComponent).low);
+            }
+        }
+    }
+}
+
+bool ReachabilityIndex::mayReach(unsigned int sourceComponent, unsigned int targetComponent) const
+{
+    if (sourceComponent < targetComponent)
+    {
+        return false;
+    }
+
+    const Interval* sourceIntervals = m_intervals.data() + static_cast<std::size_t>(sourceComponent) * m_traversalCount;
+    const Interval* targetIntervals = m_intervals.data() + static_cast<std::size_t>(targetComponent) * m_traversalCount;
+    for (unsigned int traversal = 0; traversal < m_traversalCount; ++traversal)
+    {
+        if (targetIntervals[traversal].low < sourceIntervals[traversal].low || targetIntervals[traversal].post > sourceIntervals[traversal].post)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -10,7 +10,7 @@
 #include <thread>
 
 Renderer::Renderer()
-    : m_circle{}, m_quad{}, m_textRenderer{ "res/fonts/Astron.otf", 40 }
+    : m_circle{}, m_quad{}, m_highlight{}, m_highlightVertexCount{ 0 }, m_textRenderer{ "res/fonts/Astron.otf", 40 }
 {
     initPrimitivesData();
 }
@@ -281,6 +281,44 @@ void Renderer::edgeInstanceRender(Shader& shader)
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+void Renderer::setHighlightedEdges(const std::vector<const Edge*>& edges)
+{
+    std::vector<float> vertices;
+    vertices.reserve(edges.size() * 6);
+    for (const Edge* edge : edges)
+    {
+        glm::vec2 startPos{ edge->getStartNode()->getPosition() };
+        glm::vec2 endPos{ edge->getEndNode()->getPosition() };
+        vertices.insert(vertices.end(), { startPos.x, startPos.y, 0.7f, endPos.x, endPos.y, 0.7f });
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_highlight.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_highlightVertexCount = static_cast<unsigned int>(vertices.size() / 3);
+}
+
+void Renderer::highlightedEdgesRender(Shader& shader, glm::vec4 color)
+{
+    if (m_highlightVertexCount == 0)
+    {
+        return;
+    }
+
+    shader.bind();
+    glBindVertexArray(m_highlight.VAO);
+    glVertexAttrib4f(1, color.r, color.g, color.b, color.a);
+
+    int width, height;
+    glfwGetWindowSize(glfwGetCurrentContext(), &width, &height);
+    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f, -1.0f, 1.0f);
+    shader.setMat4("projection", projection);
+    shader.setMat4("model", glm::mat4{ 1.0f });
+
+    glDrawArrays(GL_LINES, 0, m_highlightVertexCount);
+    glBindVertexArray(0);
+}
+
 void Renderer::initPrimitivesData()
 {
     glGenBuffers(1, &m_circleTranslationsVBO);
@@ -290,6 +328,7 @@ void Renderer::initPrimitivesData()
     initCircleData();
     initQuadData();
     initLineData();
+    initHighlightData();
 }
 
 
@@ -376,3 +415,18 @@ void Renderer::initLineData()
 
     glBindVertexArray(0);
 }
+
+void Renderer::initHighlightData()
+{
+    glGenVertexArrays(1, &m_highlight.VAO);
+    glBindVertexArray(m_highlight.VAO);
+
+    glGenBuffers(1, &m_highlight.VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_highlight.VBO);
+
+    // the color attribute stays disabled so the constant set before drawing applies to every vertex
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindVertexArray(0);
+}
@@ -0,0 +1,82 @@
+#include "RouteCache.h"
+
+RouteCache::RouteCache(unsigned int capacity)
+    : m_capacity{ capacity }, m_graphVersion{ 0 }, m_hits{ 0 }, m_misses{ 0 }, m_entries{}, m_index{}
+{}
+
+const PathQueryResult* RouteCache::find(unsigned int sourceNodeID, unsigned int targetNodeID, unsigned long long graphVersion)
+{
+    synchronize(graphVersion);
+
+    auto it = m_index.find(makeKey(sourceNodeID, targetNodeID));
+    if (it == m_index.end())
+    {
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return &it->second->result;
+}
+
+void RouteCache::insert(unsigned int sourceNodeID, unsigned int targetNodeID, unsigned long long graphVersion, const PathQueryResult& result)
+{
+    synchronize(graphVersion);
+    if (m_capacity == 0)
+    {
+        return;
+    }
+
+    unsigned long long key = makeKey(sourceNodeID, targetNodeID);
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        it->second->result = result;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+
+    if (m_entries.size() >= m_capacity)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+    m_entries.push_front({ key, result });
+    m_index[key] = m_entries.begin();
+}
+
+void RouteCache::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+unsigned long long RouteCache::getHits() const
+{
+    return m_hits;
+}
+
+unsigned long long RouteCache::getMisses() const
+{
+    return m_misses;
+}
+
+unsigned int RouteCache::getSize() const
+{
+    return static_cast<unsigned int>(m_entries.size());
+}
+
+unsigned long long RouteCache::makeKey(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    return (static_cast<unsigned long long>(sourceNodeID) << 32) | targetNodeID;
+}
+
+void RouteCache::synchronize(unsigned long long graphVersion)
+{
+    if (graphVersion != m_graphVersion)
+    {
+        clear();
+        m_graphVersion = graphVersion;
+    }
+}
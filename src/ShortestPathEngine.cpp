@@ -0,0 +1,492 @@
+#include "ShortestPathEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <type_traits>
+
+ShortestPathEngine::ShortestPathEngine(const CompactGraph& graph)
+    : m_graph{ graph }, m_queuePolicy{ QueuePolicy::quaternaryHeap }, m_epoch{ 0 }, m_searchSpaces{}, m_queues{}
+{}
+
+template <typename Function>
+PathQueryResult ShortestPathEngine::dispatchQueuePolicy(Function&& function, bool boundedKeyIncrease)
+{
+    switch (m_queuePolicy)
+    {
+    case QueuePolicy::lazyBinaryHeap: return function.template operator()<LazyBinaryHeap>();
+    case QueuePolicy::radixHeap:      return function.template operator()<RadixHeap>();
+    case QueuePolicy::dialBuckets:
+        if (boundedKeyIncrease && canUseDialBuckets())
+        {
+            return function.template operator()<DialBuckets>();
+        }
+        return function.template operator()<RadixHeap>();
+    default:                          return function.template operator()<QuaternaryHeap>();
+    }
+}
+
+template <typename PriorityQueue>
+PriorityQueue& ShortestPathEngine::getQueue(unsigned int direction)
+{
+    return std::get<PriorityQueue>(m_queues[direction]);
+}
+
+PathQueryResult ShortestPathEngine::query(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    return dispatchQueuePolicy([&]<typename PriorityQueue>() { return query<PriorityQueue>(sourceNodeID, targetNodeID); });
+}
+
+template <typename PriorityQueue>
+PathQueryResult ShortestPathEngine::query(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    startQuery();
+
+    PriorityQueue& pq = getQueue<PriorityQueue>(kForward);
+    pq.reset(m_graph.getNodeCount(), m_graph.getMaxWeight());
+
+    label(kForward, sourceNodeID, 0, sourceNodeID, PathQueryResult::kUnreachable);
+    pq.push(sourceNodeID, 0);
+
+    unsigned int settledNodes = 0;
+    while (!pq.empty())
+    {
+        auto [currentCost, currentNode] = pq.pop();
+
+        if (currentCost > getDistance(kForward, currentNode))
+            continue;
+
+        ++settledNodes;
+        if (currentNode == targetNodeID)
+            break;
+
+        auto neighbors = m_graph.getOutNeighbors(currentNode);
+        auto weights = m_graph.getOutWeights(currentNode);
+        auto edges = m_graph.getOutEdges(currentNode);
+
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            unsigned int newCost = currentCost + weights[index];
+
+            if (!isLabeled(kForward, adjNodeID) || newCost < getDistance(kForward, adjNodeID))
+            {
+                label(kForward, adjNodeID, newCost, currentNode, edges[index]);
+                pq.push(adjNodeID, newCost);
+            }
+        }
+    }
+
+    return extractPath(sourceNodeID, targetNodeID, isLabeled(kForward, targetNodeID) ? targetNodeID : PathQueryResult::kUnreachable, settledNodes);
+}
+
+void ShortestPathEngine::rangeQuery(unsigned int sourceNodeID, unsigned int maxDistance, std::vector<std::pair<unsigned int, unsigned int>>& reachedNodes)
+{
+    startQuery();
+    reachedNodes.clear();
+
+    QuaternaryHeap& pq = getQueue<QuaternaryHeap>(kForward);
+    pq.reset(m_graph.getNodeCount(), m_graph.getMaxWeight());
+
+    label(kForward, sourceNodeID, 0, sourceNodeID, PathQueryResult::kUnreachable);
+    pq.push(sourceNodeID, 0);
+
+    while (!pq.empty())
+    {
+        auto [currentCost, currentNode] = pq.pop();
+        reachedNodes.push_back({ currentNode, currentCost });
+
+        auto neighbors = m_graph.getOutNeighbors(currentNode);
+        auto weights = m_graph.getOutWeights(currentNode);
+        auto edges = m_graph.getOutEdges(currentNode);
+
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            unsigned int newCost = currentCost + weights[index];
+
+            if (newCost <= maxDistance && (!isLabeled(kForward, adjNodeID) || newCost < getDistance(kForward, adjNodeID)))
+            {
+                label(kForward, adjNodeID, newCost, currentNode, edges[index]);
+                pq.push(adjNodeID, newCost);
+            }
+        }
+    }
+}
+
+PathQueryResult ShortestPathEngine::bidirectionalQuery(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    return dispatchQueuePolicy([&]<typename PriorityQueue>() { return bidirectionalQuery<PriorityQueue>(sourceNodeID, targetNodeID); });
+}
+
+// Alternates a forward search over the out-arcs and a backward search over the in-arcs and stops
+// once the radii of the two searches add up to at least the best path seen so far.
+template <typename PriorityQueue>
+PathQueryResult ShortestPathEngine::bidirectionalQuery(unsigned int sourceNodeID, unsigned int targetNodeID)
+{
+    startQuery();
+
+    PriorityQueue* queues[2]{ &getQueue<PriorityQueue>(kForward), &getQueue<PriorityQueue>(kBackward) };
+    for (unsigned int direction : { kForward, kBackward })
+    {
+        queues[direction]->reset(m_graph.getNodeCount(), m_graph.getMaxWeight());
+    }
+
+    label(kForward, sourceNodeID, 0, sourceNodeID, PathQueryResult::kUnreachable);
+    label(kBackward, targetNodeID, 0, targetNodeID, PathQueryResult::kUnreachable);
+    queues[kForward]->push(sourceNodeID, 0);
+    queues[kBackward]->push(targetNodeID, 0);
+
+    unsigned int bestDistance = PathQueryResult::kUnreachable;
+    unsigned int meetingNodeID = PathQueryResult::kUnreachable;
+    if (sourceNodeID == targetNodeID)
+    {
+        bestDistance = 0;
+        meetingNodeID = sourceNodeID;
+    }
+
+    unsigned int radii[2]{ 0, 0 };
+    unsigned int settledNodes = 0;
+    for (unsigned int direction = kForward; ; direction ^= 1)
+    {
+        PriorityQueue& pq = *queues[direction];
+
+        unsigned int currentCost = 0;
+        unsigned int currentNode = 0;
+        do
+        {
+            if (pq.empty())
+            {
+                return extractPath(sourceNodeID, targetNodeID, meetingNodeID, settledNodes);
+            }
+            std::tie(currentCost, currentNode) = pq.pop();
+        } while (currentCost > getDistance(direction, currentNode));
+
+        ++settledNodes;
+        radii[direction] = currentCost;
+        if (bestDistance != PathQueryResult::kUnreachable && radii[kForward] + radii[kBackward] >= bestDistance)
+        {
+            break;
+        }
+
+        const unsigned int otherDirection = direction ^ 1;
+        auto neighbors = direction == kForward ? m_graph.getOutNeighbors(currentNode) : m_graph.getInNeighbors(currentNode);
+        auto weights = direction == kForward ? m_graph.getOutWeights(currentNode) : m_graph.getInWeights(currentNode);
+        auto edges = direction == kForward ? m_graph.getOutEdges(currentNode) : m_graph.getInEdges(currentNode);
+
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            unsigned int newCost = currentCost + weights[index];
+
+            if (!isLabeled(direction, adjNodeID) || newCost < getDistance(direction, adjNodeID))
+            {
+                label(direction, adjNodeID, newCost, currentNode, edges[index]);
+                pq.push(adjNodeID, newCost);
+            }
+
+            if (isLabeled(otherDirection, adjNodeID) && newCost + getDistance(otherDirection, adjNodeID) < bestDistance)
+            {
+                bestDistance = newCost + getDistance(otherDirection, adjNodeID);
+                meetingNodeID = adjNodeID;
+            }
+        }
+    }
+
+    return extractPath(sourceNodeID, targetNodeID, meetingNodeID, settledNodes);
+}
+
+template <typename Heuristic>
+PathQueryResult ShortestPathEngine::aStarQuery(unsigned int sourceNodeID, unsigned int targetNodeID, const Heuristic& heuristic)
+{
+    return dispatchQueuePolicy([&]<typename PriorityQueue>()
+    {
+        if constexpr (std::is_same_v<PriorityQueue, DialBuckets> && !Heuristic::kBoundedKeyIncrease)
+        {
+            return aStarQuery<RadixHeap>(sourceNodeID, targetNodeID, heuristic);
+        }
+        else
+        {
+            return aStarQuery<PriorityQueue>(sourceNodeID, targetNodeID, heuristic);
+        }
+    }, Heuristic::kBoundedKeyIncrease);
+}
+
+// Keys are distance + estimate. A consistent estimate keeps them monotone; Dial's buckets also need the key to grow by
+// a bounded amount per arc, which kBoundedKeyIncrease promises as at most twice the arc weight.
+// An estimate of kUnreachable means the target can't be reached from that node, so it is never queued.
+template <typename PriorityQueue, typename Heuristic>
+PathQueryResult ShortestPathEngine::aStarQuery(unsigned int sourceNodeID, unsigned int targetNodeID, const Heuristic& heuristic)
+{
+    startQuery();
+
+    static_assert(!std::is_same_v<PriorityQueue, DialBuckets> || Heuristic::kBoundedKeyIncrease, "A* keys can jump past the Dial bucket range");
+
+    PriorityQueue& pq = getQueue<PriorityQueue>(kForward);
+    pq.reset(m_graph.getNodeCount(), 2 * m_graph.getMaxWeight());
+
+    unsigned int sourceEstimate = heuristic.estimate(sourceNodeID);
+    if (sourceEstimate == PathQueryResult::kUnreachable)
+    {
+        return {};
+    }
+
+    label(kForward, sourceNodeID, 0, sourceNodeID, PathQueryResult::kUnreachable);
+    pq.push(sourceNodeID, sourceEstimate);
+
+    unsigned int settledNodes = 0;
+    while (!pq.empty())
+    {
+        auto [currentKey, currentNode] = pq.pop();
+
+        unsigned int currentCost = getDistance(kForward, currentNode);
+        if (currentKey > currentCost + heuristic.estimate(currentNode))
+            continue;
+
+        ++settledNodes;
+        if (currentNode == targetNodeID)
+            break;
+
+        auto neighbors = m_graph.getOutNeighbors(currentNode);
+        auto weights = m_graph.getOutWeights(currentNode);
+        auto edges = m_graph.getOutEdges(currentNode);
+
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            unsigned int newCost = currentCost + weights[index];
+
+            if (!isLabeled(kForward, adjNodeID) || newCost < getDistance(kForward, adjNodeID))
+            {
+                unsigned int adjEstimate = heuristic.estimate(adjNodeID);
+                if (adjEstimate == PathQueryResult::kUnreachable)
+                {
+                    continue;
+                }
+
+                label(kForward, adjNodeID, newCost, currentNode, edges[index]);
+                pq.push(adjNodeID, newCost + adjEstimate);
+            }
+        }
+    }
+
+    return extractPath(sourceNodeID, targetNodeID, isLabeled(kForward, targetNodeID) ? targetNodeID : PathQueryResult::kUnreachable, settledNodes);
+}
+
+template PathQueryResult ShortestPathEngine::query<LazyBinaryHeap>(unsigned int, unsigned int);
+template PathQueryResult ShortestPathEngine::query<QuaternaryHeap>(unsigned int, unsigned int);
+template PathQueryResult ShortestPathEngine::query<RadixHeap>(unsigned int, unsigned int);
+template PathQueryResult ShortestPathEngine::query<DialBuckets>(unsigned int, unsigned int);
+template PathQueryResult ShortestPathEngine::bidirectionalQuery<LazyBinaryHeap>(unsigned int, unsigned int);
+template PathQueryResult ShortestPathEngine::bidirectionalQuery<QuaternaryHeap>(unsigned int, unsigned int);
+template PathQueryResult ShortestPathEngine::bidirectionalQuery<RadixHeap>(unsigned int, unsigned int);
+template PathQueryResult ShortestPathEngine::bidirectionalQuery<DialBuckets>(unsigned int, unsigned int);
+template PathQueryResult ShortestPathEngine::aStarQuery(unsigned int, unsigned int, const GeoHeuristic&);
+template PathQueryResult ShortestPathEngine::aStarQuery(unsigned int, unsigned int, const LandmarkHeuristic&);
+
+void ShortestPathEngine::setQueuePolicy(QueuePolicy policy)
+{
+    m_queuePolicy = policy;
+}
+
+QueuePolicy ShortestPathEngine::getQueuePolicy() const
+{
+    return m_queuePolicy;
+}
+
+QueuePolicy ShortestPathEngine::benchmarkQueuePolicies(unsigned int sampleQueries)
+{
+    const unsigned int nodeCount = m_graph.getNodeCount();
+    if (nodeCount == 0)
+    {
+        return m_queuePolicy;
+    }
+
+    std::mt19937 generator{ 1337 };
+    std::uniform_int_distribution<unsigned int> distribution{ 0, nodeCount - 1 };
+    std::vector<std::pair<unsigned int, unsigned int>> queries(sampleQueries);
+    for (auto& [sourceNodeID, targetNodeID] : queries)
+    {
+        sourceNodeID = distribution(generator);
+        targetNodeID = distribution(generator);
+    }
+
+    QueuePolicy bestPolicy = m_queuePolicy;
+    double bestTime = std::numeric_limits<double>::max();
+
+    for (QueuePolicy policy : { QueuePolicy::lazyBinaryHeap, QueuePolicy::quaternaryHeap, QueuePolicy::radixHeap, QueuePolicy::dialBuckets })
+    {
+        if (policy == QueuePolicy::dialBuckets && !canUseDialBuckets())
+        {
+            continue;
+        }
+
+        m_queuePolicy = policy;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& [sourceNodeID, targetNodeID] : queries)
+        {
+            query(sourceNodeID, targetNodeID);
+        }
+        double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << getQueuePolicyName(policy) << ": " << time << " ms for " << sampleQueries << " queries\n";
+        if (time < bestTime)
+        {
+            bestTime = time;
+            bestPolicy = policy;
+        }
+    }
+
+    m_queuePolicy = bestPolicy;
+    return bestPolicy;
+}
+
+const char* ShortestPathEngine::getQueuePolicyName(QueuePolicy policy)
+{
+    switch (policy)
+    {
+    case QueuePolicy::lazyBinaryHeap: return "lazy binary heap";
+    case QueuePolicy::quaternaryHeap: return "4-ary heap";
+    case QueuePolicy::radixHeap:      return "radix heap";
+    case QueuePolicy::dialBuckets:    return "Dial buckets";
+    }
+    return "";
+}
+
+void ShortestPathEngine::computeDistances(const CompactGraph& graph, unsigned int sourceNodeID, bool reverse, std::vector<unsigned int>& distances
+                                         , std::vector<unsigned int>* parentNodes, std::vector<unsigned int>* settledOrder)
+{
+    const unsigned int nodeCount = graph.getNodeCount();
+    distances.assign(nodeCount, PathQueryResult::kUnreachable);
+    if (parentNodes)
+    {
+        parentNodes->assign(nodeCount, PathQueryResult::kUnreachable);
+    }
+    if (settledOrder)
+    {
+        settledOrder->clear();
+    }
+
+    QuaternaryHeap pq;
+    pq.reset(nodeCount, graph.getMaxWeight());
+
+    distances[sourceNodeID] = 0;
+    pq.push(sourceNodeID, 0);
+
+    while (!pq.empty())
+    {
+        auto [currentCost, currentNode] = pq.pop();
+        if (settledOrder)
+        {
+            settledOrder->push_back(currentNode);
+        }
+
+        auto neighbors = reverse ? graph.getInNeighbors(currentNode) : graph.getOutNeighbors(currentNode);
+        auto weights = reverse ? graph.getInWeights(currentNode) : graph.getOutWeights(currentNode);
+
+        for (unsigned int index = 0; index < neighbors.size(); ++index)
+        {
+            unsigned int adjNodeID = neighbors[index];
+            unsigned int newCost = currentCost + weights[index];
+
+            if (newCost < distances[adjNodeID])
+            {
+                distances[adjNodeID] = newCost;
+                if (parentNodes)
+                {
+                    (*parentNodes)[adjNodeID] = currentNode;
+                }
+                pq.push(adjNodeID, newCost);
+            }
+        }
+    }
+}
+
+void ShortestPathEngine::startQuery()
+{
+    const unsigned int nodeCount = m_graph.getNodeCount();
+    if (m_searchSpaces[kForward].epochs.size() != nodeCount)
+    {
+        for (SearchSpace& searchSpace : m_searchSpaces)
+        {
+            searchSpace.epochs.assign(nodeCount, 0);
+            searchSpace.distances.resize(nodeCount);
+            searchSpace.parentNodes.resize(nodeCount);
+            searchSpace.parentEdges.resize(nodeCount);
+        }
+        m_epoch = 0;
+    }
+
+    if (++m_epoch == 0)
+    {
+        for (SearchSpace& searchSpace : m_searchSpaces)
+        {
+            std::fill(searchSpace.epochs.begin(), searchSpace.epochs.end(), 0);
+        }
+        m_epoch = 1;
+    }
+}
+
+bool ShortestPathEngine::isLabeled(unsigned int direction, unsigned int nodeID) const
+{
+    return m_searchSpaces[direction].epochs[nodeID] == m_epoch;
+}
+
+unsigned int ShortestPathEngine::getDistance(unsigned int direction, unsigned int nodeID) const
+{
+    return m_searchSpaces[direction].distances[nodeID];
+}
+
+void ShortestPathEngine::label(unsigned int direction, unsigned int nodeID, unsigned int distance, unsigned int parentNodeID, unsigned int parentEdge)
+{
+    SearchSpace& searchSpace = m_searchSpaces[direction];
+    searchSpace.epochs[nodeID] = m_epoch;
+    searchSpace.distances[nodeID] = distance;
+    searchSpace.parentNodes[nodeID] = parentNodeID;
+    searchSpace.parentEdges[nodeID] = parentEdge;
+}
+
+// The forward parents lead from the meeting node back to the source, the backward parents from it on to the target.
+// A plain query meets at the target, where no backward labels exist.
+PathQueryResult ShortestPathEngine::extractPath(unsigned int sourceNodeID, unsigned int targetNodeID, unsigned int meetingNodeID, unsigned int settledNodes) const
+{
+    PathQueryResult result;
+    result.settledNodes = settledNodes;
+
+    if (meetingNodeID == PathQueryResult::kUnreachable)
+    {
+        return result;
+    }
+
+    const SearchSpace& forward = m_searchSpaces[kForward];
+    for (unsigned int nodeID = meetingNodeID; nodeID != sourceNodeID; nodeID = forward.parentNodes[nodeID])
+    {
+        result.path.push_back(nodeID);
+        result.edges.push_back(forward.parentEdges[nodeID]);
+    }
+    result.path.push_back(sourceNodeID);
+
+    std::reverse(result.path.begin(), result.path.end());
+    std::reverse(result.edges.begin(), result.edges.end());
+    result.distance = forward.distances[meetingNodeID];
+
+    if (meetingNodeID != targetNodeID)
+    {
+        const SearchSpace& backward = m_searchSpaces[kBackward];
+        result.distance += backward.distances[meetingNodeID];
+        for (unsigned int nodeID = meetingNodeID; nodeID != targetNodeID; nodeID = backward.parentNodes[nodeID])
+        {
+            result.edges.push_back(backward.parentEdges[nodeID]);
+            result.path.push_back(backward.parentNodes[nodeID]);
+        }
+    }
+
+    return result;
+}
+
+// The ring holds maxWeight + 1 buckets and a query sweeps up to nodeCount * maxWeight keys, so Dial only pays off
+// while the ring is no larger than the graph itself; kMaxDialBuckets bounds the memory on large maps.
+bool ShortestPathEngine::canUseDialBuckets() const
+{
+    return m_graph.getMaxWeight() < std::min(kMaxDialBuckets, m_graph.getNodeCount());
+}
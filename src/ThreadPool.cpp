@@ -0,0 +1,105 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace
+{
+    thread_local bool t_insideJob = false;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : m_workers{}, m_generation{ 0 }, m_pendingWorkers{ 0 }, m_stopping{ false }, m_activeThreads{ 0 }, m_task{ nullptr }, m_context{ nullptr }
+{
+    threadCount = std::max(1u, threadCount);
+    m_workers.reserve(threadCount - 1);
+    for (unsigned int threadIndex = 1; threadIndex < threadCount; ++threadIndex)
+    {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, threadIndex);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::getShared()
+{
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(m_workers.size()) + 1;
+}
+
+bool ThreadPool::runTask(unsigned int threadCount, TaskFunction task, void* context)
+{
+    if (t_insideJob)
+    {
+        return false;
+    }
+    std::unique_lock<std::mutex> runLock(m_runMutex, std::try_to_lock);
+    if (!runLock.owns_lock())
+    {
+        return false;
+    }
+
+    // every worker acknowledges every job, even when it has nothing to do, so none of them can mistake the fields of
+    // the next job for this one
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = task;
+        m_context = context;
+        m_activeThreads = std::min(threadCount, getThreadCount());
+        m_pendingWorkers.store(static_cast<unsigned int>(m_workers.size()), std::memory_order_relaxed);
+        ++m_generation;
+    }
+    m_wakeCondition.notify_all();
+
+    t_insideJob = true;
+    task(context, 0);
+    t_insideJob = false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this]() { return m_pendingWorkers.load(std::memory_order_acquire) == 0; });
+    return true;
+}
+
+void ThreadPool::workerLoop(unsigned int threadIndex)
+{
+    unsigned long long seenGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCondition.wait(lock, [&]() { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping)
+            {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        if (threadIndex < m_activeThreads)
+        {
+            t_insideJob = true;
+            m_task(m_context, threadIndex);
+            t_insideJob = false;
+        }
+
+        if (m_pendingWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_doneCondition.notify_one();
+        }
+    }
+}
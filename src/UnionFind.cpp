@@ -0,0 +1,75 @@
+#include "UnionFind.h"
+
+UnionFind::UnionFind(unsigned int size)
+    : m_parents{}, m_ranks{}, m_componentCount{ 0 }
+{
+    reset(size);
+}
+
+void UnionFind::reset(unsigned int size)
+{
+    m_parents.resize(size);
+    m_ranks.assign(size, 0);
+    for (unsigned int element = 0; element < size; ++element)
+    {
+        m_parents[element] = element;
+    }
+    m_componentCount = size;
+}
+
+unsigned int UnionFind::addElement()
+{
+    unsigned int element = static_cast<unsigned int>(m_parents.size());
+    m_parents.push_back(element);
+    m_ranks.push_back(0);
+    ++m_componentCount;
+    return element;
+}
+
+unsigned int UnionFind::find(unsigned int element)
+{
+    while (m_parents[element] != element)
+    {
+        m_parents[element] = m_parents[m_parents[element]];
+        element = m_parents[element];
+    }
+    return element;
+}
+
+bool UnionFind::unite(unsigned int first, unsigned int second)
+{
+    unsigned int firstRoot = find(first);
+    unsigned int secondRoot = find(second);
+
+    if (firstRoot == secondRoot)
+    {
+        return false;
+    }
+
+    if (m_ranks[firstRoot] < m_ranks[secondRoot])
+    {
+        m_parents[firstRoot] = secondRoot;
+    }
+    else if (m_ranks[firstRoot] > m_ranks[secondRoot])
+    {
+        m_parents[secondRoot] = firstRoot;
+    }
+    else
+    {
+        m_parents[secondRoot] = firstRoot;
+        ++m_ranks[firstRoot];
+    }
+
+    --m_componentCount;
+    return true;
+}
+
+unsigned int UnionFind::getSize() const
+{
+    return static_cast<unsigned int>(m_parents.size());
+}
+
+unsigned int UnionFind::getComponentCount() const
+{
+    return m_componentCount;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "CompactGraph.h"
+#include "Edge.h"
+#include <limits>
+#include <string>
+#include <vector>
+
+// Full distance matrix over signed edge weights, row-major by source. Floyd-Warshall runs on 64x64 blocks so the
+// three blocks of an update stay in cache, the blocks of a round being relaxed in parallel; Johnson's reweights the
+// arcs with Bellman-Ford potentials and runs one Dijkstra per source in parallel. Both fail on a negative cycle.
+class AllPairsShortestPaths
+{
+public:
+    static constexpr int kUnreachable = std::numeric_limits<int>::max();
+
+    AllPairsShortestPaths();
+
+    bool computeFloydWarshall(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented);
+    bool computeJohnson(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented);
+    // Johnson's without keeping the matrix: rows go to the file a batch at a time, in the format save writes.
+    bool streamJohnson(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented, const std::string& filePath);
+    void clear();
+    bool save(const std::string& filePath) const;
+    bool load(const std::string& filePath);
+
+    // Blocked Floyd-Warshall does n^3 / 8 vector operations, Johnson's about n * m log n scalar ones.
+    static bool prefersFloydWarshall(unsigned int nodeCount, unsigned int arcCount);
+
+    int getDistance(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    unsigned int getNodeCount() const;
+    bool hasNegativeCycle() const;
+
+private:
+    static constexpr unsigned int kBlockSize = 64;
+    static constexpr unsigned int kStreamedRows = 256;
+
+    static void relaxBlock(int* block, const int* rowBlock, const int* columnBlock, unsigned int stride);
+    static void relaxBlockScalar(int* block, const int* rowBlock, const int* columnBlock, unsigned int stride);
+    static void relaxBlockAvx2(int* block, const int* rowBlock, const int* columnBlock, unsigned int stride);
+    static bool computePotentials(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented, std::vector<long long>& potentials);
+    static void buildReweightedGraph(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented
+                                    , const std::vector<long long>& potentials, CompactGraph& graph);
+    static void computeRows(const CompactGraph& graph, const std::vector<long long>& potentials
+                           , unsigned int firstSource, unsigned int lastSource, int* rows);
+
+private:
+    unsigned int     m_nodeCount;
+    unsigned int     m_stride;
+    bool             m_negativeCycle;
+    std::vector<int> m_distances;
+};
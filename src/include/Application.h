@@ -21,6 +21,7 @@ public:
 private:
     void renderUI();
     void renderGraphEditorUI();
+    void renderGraphStatisticsUI();
     void renderMazeUI();
     void renderMapUI();
     void renderToolbar();
@@ -0,0 +1,31 @@
+#pragma once
+#include "CompactGraph.h"
+#include "ShortestPathEngine.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+struct BatchQueryResult
+{
+    std::vector<unsigned int>    distances;
+    std::vector<PathQueryResult> paths;   // filled only when paths were requested
+    double                       seconds = 0.0;
+
+    double getQueriesPerSecond() const { return seconds > 0.0 ? distances.size() / seconds : 0.0; }
+};
+
+// Answers many one-to-one queries with bidirectional Dijkstra, handing chunks of queries to the worker threads.
+// Every thread owns an engine whose search spaces and queues are reused across queries and batches.
+class BatchQueryRunner
+{
+public:
+    explicit BatchQueryRunner(const CompactGraph& graph);
+
+    BatchQueryResult run(const std::vector<std::pair<unsigned int, unsigned int>>& queries, bool withPaths, QueuePolicy queuePolicy);
+
+private:
+    static constexpr unsigned int kQueriesPerChunk = 16;
+
+    const CompactGraph&                              m_graph;
+    std::vector<std::unique_ptr<ShortestPathEngine>> m_engines;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Square matrix of bits, every row padded to a multiple of 256 bits so rows can be combined a vector at a time.
+class BitMatrix
+{
+public:
+    static constexpr unsigned int kWordsPerVector = 4;
+
+    void resize(unsigned int size)
+    {
+        m_size = size;
+        m_wordsPerRow = (size + 255) / 256 * kWordsPerVector;
+        m_words.assign(static_cast<std::size_t>(m_wordsPerRow) * size, 0);
+    }
+
+    unsigned int getSize() const
+    {
+        return m_size;
+    }
+
+    unsigned int getWordsPerRow() const
+    {
+        return m_wordsPerRow;
+    }
+
+    bool test(unsigned int row, unsigned int column) const
+    {
+        return (getRow(row)[column / 64] >> (column % 64)) & 1;
+    }
+
+    void set(unsigned int row, unsigned int column)
+    {
+        getRow(row)[column / 64] |= std::uint64_t{ 1 } << (column % 64);
+    }
+
+    std::uint64_t* getRow(unsigned int row)
+    {
+        return m_words.data() + static_cast<std::size_t>(row) * m_wordsPerRow;
+    }
+
+    const std::uint64_t* getRow(unsigned int row) const
+    {
+        return m_words.data() + static_cast<std::size_t>(row) * m_wordsPerRow;
+    }
+
+private:
+    unsigned int               m_size        = 0;
+    unsigned int               m_wordsPerRow = 0;
+    std::vector<std::uint64_t> m_words;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include "Edge.h"
+#include <span>
+#include <vector>
+
+class CompactGraph
+{
+public:
+    CompactGraph();
+
+    void build(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented);
+    void clear();
+    void setEdgeWeight(unsigned int edgeIndex, unsigned int startNodeID, unsigned int endNodeID, unsigned int weight);
+    // Rewrites the arcs of one edge without touching the maximum weight, so distinct edges can be updated concurrently;
+    // the caller raises the maximum once for the whole batch.
+    void setArcWeights(unsigned int edgeIndex, unsigned int startNodeID, unsigned int endNodeID, unsigned int weight);
+    void raiseMaxWeight(unsigned int weight);
+
+    unsigned int getNodeCount() const;
+    unsigned int getArcCount()  const;
+    unsigned int getMaxWeight() const;
+    bool         isOriented()   const;
+
+    unsigned long long getFingerprint()  const;
+    unsigned long long getMemoryUsage()  const;
+
+    std::span<const unsigned int> getOutNeighbors(unsigned int nodeID) const;
+    std::span<const unsigned int> getOutWeights(unsigned int nodeID)   const;
+    std::span<const unsigned int> getOutEdges(unsigned int nodeID)     const;
+    std::span<const unsigned int> getInNeighbors(unsigned int nodeID)  const;
+    std::span<const unsigned int> getInWeights(unsigned int nodeID)    const;
+    std::span<const unsigned int> getInEdges(unsigned int nodeID)      const;
+
+private:
+    void setArcWeight(std::vector<unsigned int>& offsets, std::vector<unsigned int>& weights, const std::vector<unsigned int>& edgeIndices
+                     , unsigned int nodeID, unsigned int edgeIndex, unsigned int weight);
+
+private:
+    unsigned int m_nodeCount;
+    bool         m_oriented;
+    unsigned int m_maxWeight;
+
+    std::vector<unsigned int> m_outOffsets;
+    std::vector<unsigned int> m_outTargets;
+    std::vector<unsigned int> m_outWeights;
+    std::vector<unsigned int> m_outEdges;
+
+    std::vector<unsigned int> m_inOffsets;
+    std::vector<unsigned int> m_inSources;
+    std::vector<unsigned int> m_inWeights;
+    std::vector<unsigned int> m_inEdges;
+};
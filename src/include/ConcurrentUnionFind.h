@@ -0,0 +1,20 @@
+#pragma once
+#include <atomic>
+#include <vector>
+
+class ConcurrentUnionFind
+{
+public:
+    explicit ConcurrentUnionFind(unsigned int size);
+
+    unsigned int find(unsigned int element);
+    void unite(unsigned int first, unsigned int second);
+    void compress();
+
+    unsigned int getSize() const;
+    unsigned int getParent(unsigned int element) const;
+    std::vector<unsigned int> getLabels() const;
+
+private:
+    std::vector<std::atomic<unsigned int>> m_parents;
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include "CompactGraph.h"
+#include "PriorityQueues.h"
+#include "ShortestPathEngine.h"
+#include <string>
+#include <vector>
+
+// Contraction Hierarchies: nodes are contracted in rounds of independent sets ordered by edge difference,
+// shortcuts keep the distances between the remaining nodes and queries only walk upward in rank from both ends.
+class ContractionHierarchy
+{
+public:
+    static constexpr unsigned int kNoArc = 0xFFFFFFFF;
+
+    struct Arc
+    {
+        unsigned int startNodeID;
+        unsigned int endNodeID;
+        unsigned int weight;
+        unsigned int edgeIndex;   // original edge, kNoArc for shortcuts
+        unsigned int firstChild;  // shortcut halves, kNoArc for original arcs
+        unsigned int secondChild;
+    };
+
+    ContractionHierarchy();
+
+    void build(const CompactGraph& graph);
+    void clear();
+    bool save(const std::string& filePath, const CompactGraph& graph) const;
+    bool load(const std::string& filePath, const CompactGraph& graph);
+
+    PathQueryResult query(unsigned int sourceNodeID, unsigned int targetNodeID);
+    // PHAST: an upward search from the source, then one sweep over the downward arcs in descending rank order.
+    void computeDistances(unsigned int sourceNodeID, std::vector<unsigned int>& distances) const;
+    void unpackArc(unsigned int arcID, std::vector<unsigned int>& edges, std::vector<unsigned int>& path) const;
+
+    bool isBuilt() const;
+    unsigned int getNodeCount() const;
+    unsigned int getRank(unsigned int nodeID) const;
+    unsigned int getShortcutCount() const;
+    unsigned long long getMemoryUsage() const;
+    const std::vector<Arc>& getArcs() const;
+    std::span<const unsigned int> getUpwardArcs(unsigned int nodeID) const;
+    std::span<const unsigned int> getDownwardArcs(unsigned int nodeID) const;
+
+private:
+    bool isConsistent(const CompactGraph& graph) const;
+
+private:
+    static constexpr unsigned int kForward  = 0;
+    static constexpr unsigned int kBackward = 1;
+
+    struct SearchSpace
+    {
+        std::vector<unsigned int> epochs;
+        std::vector<unsigned int> distances;
+        std::vector<unsigned int> parentArcs;
+    };
+
+private:
+    unsigned int              m_nodeCount;
+    unsigned int              m_shortcutCount;
+    std::vector<unsigned int> m_ranks;
+    std::vector<Arc>          m_arcs;
+    std::vector<unsigned int> m_upwardOffsets;
+    std::vector<unsigned int> m_upwardArcs;
+    std::vector<unsigned int> m_downwardOffsets;
+    std::vector<unsigned int> m_downwardArcs;
+
+    unsigned int   m_epoch;
+    SearchSpace    m_searchSpaces[2];
+    QuaternaryHeap m_queues[2];
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+// AVX2 kernels are compiled into every x86 build and picked at run time, so the binary still runs on CPUs without AVX2.
+// Functions using AVX2 intrinsics are marked AVX2_TARGET; MSVC accepts the intrinsics without /arch, GCC and Clang
+// need the target attribute.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HAS_AVX2_KERNELS 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+inline bool isAvx2Supported()
+{
+#if defined(HAS_AVX2_KERNELS) && defined(_MSC_VER)
+    static const bool supported = []
+    {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+
+        // AVX needs OS support for the YMM state (OSXSAVE, XCR0 bits 1 and 2) before leaf 7 is worth reading
+        __cpuid(info, 1);
+        constexpr int kOsxsave = 1 << 27, kAvx = 1 << 28;
+        if ((info[2] & (kOsxsave | kAvx)) != (kOsxsave | kAvx) || (_xgetbv(0) & 6) != 6)
+        {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return supported;
+#elif defined(HAS_AVX2_KERNELS)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "CompactGraph.h"
+#include "ShortestPathEngine.h"
+#include "glm/glm.hpp"
+#include <vector>
+
+// Customizable contraction hierarchy. The nested dissection order and the chordal fill-in depend only on the
+// topology; customize() recomputes every arc weight from the current CSR weights in parallel, level by level
+// of the elimination tree, so weight edits never touch the expensive part.
+class CustomizableHierarchy
+{
+public:
+    CustomizableHierarchy();
+
+    void build(const CompactGraph& graph, const std::vector<glm::vec2>& positions);
+    void customize(const CompactGraph& graph);
+    void clear();
+
+    PathQueryResult query(unsigned int sourceNodeID, unsigned int targetNodeID);
+
+    bool isBuilt() const;
+    unsigned int getArcCount() const;
+    unsigned int getLevelCount() const;
+
+private:
+    static constexpr unsigned int kForward  = 0;
+    static constexpr unsigned int kBackward = 1;
+
+    void dissect(std::vector<unsigned int>& nodes, const std::vector<glm::vec2>& positions, const std::vector<std::vector<unsigned int>>& neighbors
+                , std::vector<unsigned char>& sides, std::vector<unsigned int>& order) const;
+    unsigned int findArc(unsigned int lowerNodeID, unsigned int upperNodeID) const;
+    void unpackArc(unsigned int arcID, unsigned int direction, std::vector<unsigned int>& edges, std::vector<unsigned int>& path) const;
+
+private:
+    unsigned int              m_nodeCount;
+    std::vector<unsigned int> m_ranks;
+    std::vector<unsigned int> m_parents;
+
+    // arcs are stored at their lower-ranked end; forward means from the lower end to the upper one
+    std::vector<unsigned int> m_upwardOffsets;
+    std::vector<unsigned int> m_upwardTargets;
+    std::vector<unsigned int> m_arcTails;
+    std::vector<unsigned int> m_downwardOffsets;
+    std::vector<unsigned int> m_downwardSources;
+    std::vector<unsigned int> m_downwardArcs;
+    std::vector<std::vector<unsigned int>> m_nodesByLevel;
+
+    std::vector<unsigned int> m_inputArcs;
+    std::vector<unsigned int> m_inputDirections;
+
+    std::vector<unsigned int> m_weights[2];
+    std::vector<unsigned int> m_middleNodes[2];
+    std::vector<unsigned int> m_edges[2];
+
+    std::vector<unsigned int> m_distances[2];
+    std::vector<unsigned int> m_parentArcs[2];
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include "CompactGraph.h"
+#include <vector>
+
+// Parallel one-to-all shortest paths. Nodes are kept in buckets of width bucketWidth; a bucket is drained by
+// relaxing light arcs (weight <= bucketWidth) in parallel until it stays empty, then the heavy arcs of everything
+// it settled are relaxed once. Improved nodes are collected in per-thread request buffers and bucketed afterwards.
+class DeltaStepping
+{
+public:
+    static unsigned int suggestBucketWidth(const CompactGraph& graph);
+
+    // Same output as ShortestPathEngine::computeDistances: unreached nodes and the source keep kUnreachable as parent.
+    static void computeDistances(const CompactGraph& graph, unsigned int sourceNodeID, unsigned int bucketWidth
+                                , std::vector<unsigned int>& distances, std::vector<unsigned int>& parentNodes);
+
+private:
+    static constexpr unsigned int kMinParallelFrontier = 256;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include "BitMatrix.h"
+#include "Edge.h"
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Adjacency of a near-complete graph as a bit matrix plus a row-major weight matrix holding the lightest parallel edge,
+// rows padded to eight weights. Both algorithms sweep whole rows, with AVX2 kernels picked at run time when the CPU has it.
+class DenseGraph
+{
+public:
+    static constexpr float        kDensityThreshold = 0.25f;
+    static constexpr unsigned int kMaxNodeCount     = 4096;
+    static constexpr int          kNoEdge           = std::numeric_limits<int>::max();
+
+    static bool isWorthwhile(unsigned int nodeCount, float density);
+
+    DenseGraph();
+
+    void build(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented);
+    void clear();
+    bool isBuilt() const;
+
+    bool hasEdge(unsigned int startNodeID, unsigned int endNodeID) const;
+    int  getWeight(unsigned int startNodeID, unsigned int endNodeID) const;
+    const BitMatrix& getAdjacency() const;
+
+    // Bit-parallel Warshall: bit (i, j) is set when a path of at least one edge leads from i to j.
+    BitMatrix transitiveClosure() const;
+    // Array Prim from node 0 over the out-arcs, same (nodeID, parentNodeID) output as the heap version.
+    std::vector<std::pair<int, int>> primMST() const;
+
+private:
+    static constexpr unsigned int kPivotBlockSize = 64;
+    static constexpr unsigned int kWeightsPerVector = 8;
+
+    static void orRow(std::uint64_t* row, const std::uint64_t* pivotRow, unsigned int wordCount);
+    static void orRowScalar(std::uint64_t* row, const std::uint64_t* pivotRow, unsigned int wordCount);
+    static void orRowAvx2(std::uint64_t* row, const std::uint64_t* pivotRow, unsigned int wordCount);
+    // One Prim step: lowers the costs of the nodes outside the tree through parent's row and returns the smallest cost.
+    static int relaxPrimRow(const int* weights, int parent, int* minimumCostToReach, int* lastNode, const int* inTree, unsigned int stride);
+    static int relaxPrimRowScalar(const int* weights, int parent, int* minimumCostToReach, int* lastNode, const int* inTree, unsigned int stride);
+    static int relaxPrimRowAvx2(const int* weights, int parent, int* minimumCostToReach, int* lastNode, const int* inTree, unsigned int stride);
+
+private:
+    unsigned int     m_nodeCount;
+    unsigned int     m_stride;
+    bool             m_built;
+    BitMatrix        m_adjacency;
+    std::vector<int> m_weights;
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include "CompactGraph.h"
+#include "ContractionHierarchy.h"
+#include <string>
+#include <vector>
+
+// Dense many-to-many distance matrix, row-major by source. With a contraction hierarchy, the upward search spaces of
+// the targets are stored in per-node buckets and every source scans the buckets its own upward search settles;
+// without one, each source runs a one-to-all search. Sources are processed in parallel, each writing only its row.
+class DistanceTable
+{
+public:
+    DistanceTable();
+
+    void compute(const CompactGraph& graph, const ContractionHierarchy* hierarchy
+                , const std::vector<unsigned int>& sourceNodeIDs, const std::vector<unsigned int>& targetNodeIDs);
+    void clear();
+    bool save(const std::string& filePath) const;
+    bool load(const std::string& filePath);
+
+    unsigned int getDistance(unsigned int sourceIndex, unsigned int targetIndex) const;
+    const std::vector<unsigned int>& getSources() const;
+    const std::vector<unsigned int>& getTargets() const;
+    const std::vector<unsigned int>& getDistances() const;
+
+private:
+    struct BucketEntry
+    {
+        unsigned int targetIndex;
+        unsigned int distance;
+    };
+
+    struct SearchSpace
+    {
+        std::vector<unsigned int> epochs;
+        std::vector<unsigned int> distances;
+        QuaternaryHeap            queue;
+        unsigned int              epoch = 0;
+    };
+
+    static void upwardSearch(const ContractionHierarchy& hierarchy, unsigned int nodeID, bool backward, SearchSpace& searchSpace
+                            , std::vector<std::pair<unsigned int, unsigned int>>& settled);
+    void computeWithHierarchy(const ContractionHierarchy& hierarchy);
+    void computeWithSearches(const CompactGraph& graph);
+
+private:
+    std::vector<unsigned int> m_sources;
+    std::vector<unsigned int> m_targets;
+    std::vector<unsigned int> m_distances;
+};
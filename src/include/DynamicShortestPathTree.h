@@ -0,0 +1,41 @@
+#pragma once
+#include "CompactGraph.h"
+#include "PriorityQueues.h"
+#include "ShortestPathEngine.h"
+#include <vector>
+
+// Shortest path tree from one source that is repaired after single edge weight changes (Ramalingam-Reps).
+// An increase on a tree arc only recomputes the subtree hanging below it, seeded from the arcs entering it from
+// the rest of the tree; a decrease only propagates from the arc's head while distances keep improving.
+class DynamicShortestPathTree
+{
+public:
+    DynamicShortestPathTree();
+
+    void build(const CompactGraph& graph, unsigned int sourceNodeID);
+    void clear();
+
+    // To be called once the CSR holds the new weight of edgeIndex. Returns the number of nodes whose label was touched.
+    unsigned int updateEdge(const CompactGraph& graph, unsigned int edgeIndex, unsigned int startNodeID, unsigned int endNodeID);
+
+    bool isBuilt() const;
+    unsigned int getSource() const;
+    unsigned int getDistance(unsigned int nodeID) const;
+    PathQueryResult getPath(unsigned int targetNodeID) const;
+
+private:
+    void setParent(unsigned int nodeID, unsigned int parentNodeID, unsigned int parentEdge);
+    unsigned int repairIncrease(const CompactGraph& graph, unsigned int subtreeRootID);
+    unsigned int repairDecrease(const CompactGraph& graph, unsigned int nodeID, unsigned int distance, unsigned int parentNodeID, unsigned int parentEdge);
+
+private:
+    unsigned int              m_sourceNodeID;
+    std::vector<unsigned int> m_distances;
+    std::vector<unsigned int> m_parentNodes;
+    std::vector<unsigned int> m_parentEdges;
+    std::vector<std::vector<unsigned int>> m_children;
+    std::vector<unsigned int> m_childPositions;
+
+    std::vector<unsigned char> m_affected;
+    QuaternaryHeap             m_queue;
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include "CompactGraph.h"
+#include <vector>
+
+class DynamicTopologicalOrder
+{
+public:
+    DynamicTopologicalOrder();
+
+    void rebuild(const CompactGraph& graph, const std::vector<unsigned int>& order, const std::vector<unsigned int>& cycle);
+    void clear();
+
+    void addNode();
+    bool insertEdge(unsigned int startNodeID, unsigned int endNodeID);
+
+    bool isAcyclic() const;
+    unsigned int getPosition(unsigned int nodeID) const;
+    const std::vector<unsigned int>& getOrder() const;
+    const std::vector<unsigned int>& getCycle() const;
+
+private:
+    static constexpr unsigned int kNone = 0xFFFFFFFF;
+
+    bool searchForward(unsigned int startNodeID, unsigned int upperBound, unsigned int targetNodeID);
+    void searchBackward(unsigned int startNodeID, unsigned int lowerBound);
+    void reorder();
+    void recordCycle(unsigned int startNodeID, unsigned int endNodeID, unsigned int lastNodeID);
+
+private:
+    bool m_acyclic;
+    std::vector<std::vector<unsigned int>> m_outNeighbors;
+    std::vector<std::vector<unsigned int>> m_inNeighbors;
+    std::vector<unsigned int> m_positions;
+    std::vector<unsigned int> m_order;
+    std::vector<unsigned int> m_cycle;
+
+    std::vector<bool>         m_visited;
+    std::vector<unsigned int> m_parents;
+    std::vector<unsigned int> m_forwardNodes;
+    std::vector<unsigned int> m_backwardNodes;
+};
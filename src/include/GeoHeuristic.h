@@ -0,0 +1,38 @@
+#pragma once
+#include "CompactGraph.h"
+#include <vector>
+
+struct GeoCoordinate
+{
+    double latitude  = 0.0;
+    double longitude = 0.0;
+};
+
+double greatCircleDistance(const GeoCoordinate& first, const GeoCoordinate& second);
+
+// A* estimate: great-circle distance to the target scaled to the arc length unit.
+// The scale is the smallest length / distance ratio over all arcs, which keeps the estimate consistent.
+class GeoHeuristic
+{
+public:
+    // No arc of weight w is shorter than the scaled distance between its ends, so an arc moves the estimate by at most w
+    // and raises the A* key by at most 2w.
+    static constexpr bool kBoundedKeyIncrease = true;
+
+    GeoHeuristic();
+
+    bool calibrate(const CompactGraph& graph, const std::vector<GeoCoordinate>& coordinates);
+    void clear();
+    void setTarget(unsigned int targetNodeID);
+
+    unsigned int estimate(unsigned int nodeID) const;
+
+    bool   isCalibrated() const;
+    double getScale()     const;
+
+private:
+    std::vector<GeoCoordinate> m_coordinates;
+    GeoCoordinate              m_target;
+    double                     m_scale;
+    bool                       m_calibrated;
+};
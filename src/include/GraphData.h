@@ -2,6 +2,25 @@
 #include "GraphNode.h"
 #include "Edge.h"
 #include "Action.h"
+#include "AllPairsShortestPaths.h"
+#include "BatchQueryRunner.h"
+#include "CompactGraph.h"
+#include "ContractionHierarchy.h"
+#include "CustomizableHierarchy.h"
+#include "DeltaStepping.h"
+#include "DenseGraph.h"
+#include "DistanceTable.h"
+#include "DynamicShortestPathTree.h"
+#include "DynamicTopologicalOrder.h"
+#include "GeoHeuristic.h"
+#include "HubLabels.h"
+#include "KShortestPaths.h"
+#include "MinCostFlow.h"
+#include "ReachabilityIndex.h"
+#include "ShortestPathEngine.h"
+#include "Parallel.h"
+#include "UnionFind.h"
+#include <set>
 #include <stack>
 #include <unordered_set>
 
@@ -15,6 +34,28 @@ public:
             return p.first ^ p.second;
         }
     };
+
+    struct Statistics
+    {
+        unsigned int nodeCount          = 0;
+        unsigned int edgeCount          = 0;
+        unsigned int selfLoopCount      = 0;
+        unsigned int sourceCount        = 0;
+        unsigned int sinkCount          = 0;
+        unsigned int weakComponentCount = 0;
+        unsigned int maxDegree          = 0;
+        float        density            = 0.0f;
+        bool         oriented           = true;
+        bool         weighted           = false;
+        std::vector<unsigned int> degreeHistogram;
+    };
+
+    struct TopologicalOrder
+    {
+        std::vector<unsigned int>              order;
+        std::vector<std::vector<unsigned int>> levels;
+        std::vector<unsigned int>              cycle;
+    };
 public:
     GraphData();
     ~GraphData();
@@ -24,6 +65,9 @@ public:
     void setOriented(bool oriented);
     void setWeighted(bool weighted);
     void setLogAdjacency(bool log);
+    void setMaintainTopologicalOrder(bool maintain);
+    void setEdgeWeight(Edge& edge, int weight);
+    void setEdgeWeights(const std::vector<std::pair<unsigned int, int>>& edgeWeights);
     void inverseGraph();
     void clear();
     void undo();
@@ -31,28 +75,55 @@ public:
     int getSize() const;
     bool isWeighted() const;
     bool isOriented() const;
+    bool isMaintainingTopologicalOrder() const;
+    const DynamicTopologicalOrder& getDynamicTopologicalOrder() const;
     void logAdjacencyMatrix(const std::string& fileName) const;
     std::vector<GraphNode*>& getNodes();
     GraphNode* getNode(unsigned int nodeID);
     Edge* getEdge(unsigned int startNodeID, unsigned int endNodeID);
 
     GraphNode* findRoot();
-    bool isTree();
-    bool isWeaklyConnected();
+    unsigned int getInDegree(unsigned int nodeID) const;
+    unsigned int getOutDegree(unsigned int nodeID) const;
+    const Statistics& getStatistics() const;
+    bool isTree() const;
+    bool isWeaklyConnected() const;
     bool checkCycles() const;
     void reconstructGraphFromComponents(const std::vector<std::vector<unsigned int>>& components); // for strongly connected only    
     std::vector<std::vector<unsigned int>> weaklyConnectedComponents(const GraphNode* const startNode);
+    std::vector<unsigned int> weaklyConnectedComponentLabels();
     std::vector<std::vector<unsigned int>> stronglyConnectedComponents(const GraphNode* const startNode);
 
-    std::vector<unsigned int> dijkstraMinimumCost(const GraphNode* const startNode, const GraphNode* const endNode);
+    std::vector<unsigned int> dijkstraMinimumCost(const GraphNode* const startNode, const GraphNode* const endNode) const;
+    PathQueryResult shortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    BatchQueryResult batchShortestPaths(const std::vector<std::pair<unsigned int, unsigned int>>& queries, bool withPaths = false) const;
+    PathQueryResult dynamicShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    PathQueryResult bidirectionalShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    PathQueryResult aStarShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    PathQueryResult landmarkShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    PathQueryResult contractionHierarchyShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    PathQueryResult customizableShortestPath(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    std::vector<PathQueryResult> kShortestPaths(unsigned int sourceNodeID, unsigned int targetNodeID, unsigned int pathCount) const;
+    unsigned int hubLabelDistance(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    void deltaSteppingDistances(unsigned int sourceNodeID, std::vector<unsigned int>& distances, std::vector<unsigned int>& parentNodes
+                               , unsigned int bucketWidth = 0) const;
+    DistanceTable distanceTable(const std::vector<unsigned int>& sourceNodeIDs, const std::vector<unsigned int>& targetNodeIDs) const;
+    void nodesWithinDistance(unsigned int sourceNodeID, unsigned int maxDistance, std::vector<std::pair<unsigned int, unsigned int>>& reachedNodes) const;
+    void oneToAllDistances(unsigned int sourceNodeID, std::vector<unsigned int>& distances) const;
+    AllPairsShortestPaths allPairsShortestPaths() const;
+    bool saveAllPairsShortestPaths(const std::string& filePath) const;
+    QueuePolicy selectFastestQueuePolicy(unsigned int sampleQueries = 64) const;
 
     std::vector<std::pair<int, int>> primMST();
+    BitMatrix transitiveClosure() const;
     std::vector<std::pair<int, int>> genericMST();
     std::vector<std::pair<int, int>> kruskalMST();
     std::pair<std::vector<std::pair<int, int>>, int> fordFulkersonMinCut(
         const GraphNode* const sourceNode,
         const GraphNode* const sinkNode
     );
+    MinCostFlowResult minCostFlow(unsigned int sourceNodeID, unsigned int sinkNodeID, const std::vector<int>& edgeCosts
+                                 , long long flowLimit = MinCostFlow::kUnlimitedFlow) const;
     unsigned int bfsFindAugmentingPath(
         unsigned int sourceID,
         unsigned int sinkID,
@@ -69,14 +140,62 @@ public:
     std::vector<unsigned int> DFS(const GraphNode* const startNode) const;
     std::vector<unsigned int> genericPathTraversal(const GraphNode* const startNode) const;
     std::vector<unsigned int> totalGenericPathTraversal(const GraphNode* const startNode) const;
-    std::vector<unsigned int> topologicalSort(const GraphNode* const startNode);
+    std::vector<unsigned int> topologicalSort() const;
+    TopologicalOrder          topologicalLevels() const;
+    bool                      canReach(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+    const ReachabilityIndex&  getReachabilityIndex() const;
+    bool                      hasEdge(unsigned int startNodeID, unsigned int endNodeID) const;
+    bool                      isDenseMode() const;
+    const DenseGraph&         getDenseGraph() const;
+
+    template <typename Function>
+    static void forEachTopologicalLevel(const TopologicalOrder& topologicalOrder, Function&& function)
+    {
+        for (const auto& level : topologicalOrder.levels)
+        {
+            parallelFor(0, static_cast<unsigned int>(level.size()), [&](unsigned int index) { function(level[index]); }, 256);
+        }
+    }
 
     void updateAdjacencyList();
     const std::vector<Edge>& getEdges() const;
     std::vector<Edge>& getEdgesRef();
     const std::vector<std::unordered_set<int>>& getAdjacencyList() const;
+    const CompactGraph& getCompactGraph() const;
+    unsigned long long getVersion() const;
+    void setGeoCoordinates(std::vector<GeoCoordinate> coordinates);
+    const std::vector<GeoCoordinate>& getGeoCoordinates() const;
+    bool hasGeoHeuristic() const;
+    void buildLandmarks(unsigned int landmarkCount, LandmarkSelection selection);
+    bool saveLandmarks(const std::string& filePath) const;
+    bool loadLandmarks(const std::string& filePath);
+    bool hasLandmarks() const;
+    void buildContractionHierarchy();
+    bool saveContractionHierarchy(const std::string& filePath) const;
+    bool loadContractionHierarchy(const std::string& filePath);
+    bool hasContractionHierarchy() const;
+    const ContractionHierarchy& getContractionHierarchy() const;
+    void buildHubLabels();
+    bool hasHubLabels() const;
+    const HubLabels& getHubLabels() const;
+    void buildCustomizableHierarchy();
+    void customizeHierarchy() const;
+    bool hasCustomizableHierarchy() const;
+    const CustomizableHierarchy& getCustomizableHierarchy() const;
     std::unordered_map<std::pair<int, int>, int, PairHash>& getEdgeWeights();
 
+private:
+    template <typename PriorityQueue>
+    std::vector<std::pair<int, int>> primMST() const;
+
+    void rebuildTopologicalOrder();
+    void rebuildStatistics();
+    void countNode(unsigned int nodeID);
+    void countEdge(unsigned int startNodeID, unsigned int endNodeID);
+    void countDegreeIncrease(unsigned int nodeID);
+    void updateDensity();
+    void invalidateWeights();
+
 private:
     bool m_logAdjacencyMatrix;
     bool m_oriented;
@@ -86,4 +205,29 @@ private:
     std::vector<GraphNode*>              m_nodes;
     std::vector<Edge>                    m_edges;
     std::unordered_map<std::pair<int, int>, int, PairHash> m_edgeWeights;
+    mutable CompactGraph                 m_compactGraph;
+    mutable bool                         m_compactGraphDirty;
+    mutable unsigned long long           m_version;
+    mutable ShortestPathEngine           m_shortestPathEngine;
+    mutable unsigned long long           m_queuePolicyVersion;
+    mutable BatchQueryRunner             m_batchQueryRunner;
+    std::vector<GeoCoordinate>           m_geoCoordinates;
+    mutable GeoHeuristic                 m_geoHeuristic;
+    mutable bool                         m_geoHeuristicDirty;
+    mutable LandmarkHeuristic            m_landmarkHeuristic;
+    mutable ContractionHierarchy         m_contractionHierarchy;
+    bool                                 m_contractionHierarchyStale;
+    mutable HubLabels                    m_hubLabels;
+    mutable CustomizableHierarchy        m_customizableHierarchy;
+    mutable bool                         m_customizationDirty;
+    mutable DynamicShortestPathTree      m_shortestPathTree;
+    mutable ReachabilityIndex            m_reachabilityIndex;
+    mutable DenseGraph                   m_denseGraph;
+    bool                                 m_maintainTopologicalOrder;
+    DynamicTopologicalOrder              m_topologicalOrder;
+    UnionFind                            m_weakComponents;
+    std::vector<unsigned int>            m_inDegree;
+    std::vector<unsigned int>            m_outDegree;
+    std::set<unsigned int>               m_sourceNodes;
+    Statistics                           m_statistics;
 };
\ No newline at end of file
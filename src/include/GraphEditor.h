@@ -13,6 +13,11 @@ public:
     void render();
     void handleInput();
 
+    void showRoute(unsigned int sourceNodeID, unsigned int targetNodeID);
+    void runBatchQueries(const std::string& filePath);
+    void exportAllPairsShortestPaths(const std::string& filePath);
+    void runMinCostFlow(unsigned int sourceNodeID, unsigned int sinkNodeID, const std::string& costsFilePath);
+
     GraphData& getGraphData();
     const GraphNode* const getSelectedNode() const;
     void setSelectedNode(GraphNode* node);
@@ -22,10 +27,17 @@ private:
     void checkNodeSelect(glm::vec2 position);
     bool checkEdgeSelect(glm::vec2 position);
     bool checkValidNodePosition(glm::vec2 position);
+    void highlightRoute();
+    void dropStaleRoute();
 private:
     static constexpr float kNodeRadius = 30.0f;
 private:
     GraphNode* m_selectedNode;
+    unsigned int m_routeSourceID;
+    unsigned int m_routeTargetID;
+    std::vector<unsigned int> m_routeEdges;
+    std::vector<glm::vec4> m_routeEdgeColors;
+    unsigned long long m_routeVersion;
     GraphData m_graphData;
     Renderer m_renderer;
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#include "ContractionHierarchy.h"
+#include <vector>
+
+// Hub labels taken from the upward search spaces of a contraction hierarchy and pruned to exact entries.
+// Each label is a hub-sorted run of (hub, distance) pairs in two parallel arrays closed by a sentinel hub,
+// so a query is a single branch-light merge of two runs.
+class HubLabels
+{
+public:
+    HubLabels();
+
+    void build(const ContractionHierarchy& hierarchy);
+    void clear();
+
+    unsigned int distance(unsigned int sourceNodeID, unsigned int targetNodeID) const;
+
+    bool isBuilt() const;
+    double getAverageLabelSize() const;
+    unsigned long long getMemoryUsage() const;
+
+private:
+    struct Label
+    {
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> hubs;
+        std::vector<unsigned int> distances;
+    };
+
+    static unsigned int mergeDistance(const unsigned int* firstHubs, const unsigned int* firstDistances
+                                     , const unsigned int* secondHubs, const unsigned int* secondDistances);
+
+private:
+    unsigned int m_nodeCount;
+    Label        m_forwardLabels;
+    Label        m_backwardLabels;
+};
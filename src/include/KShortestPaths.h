@@ -0,0 +1,37 @@
+#pragma once
+#include "CompactGraph.h"
+#include "PriorityQueues.h"
+#include "ShortestPathEngine.h"
+#include <vector>
+
+// Yen's k shortest loopless paths. The reverse shortest path tree to the target is computed once: its distances
+// are an exact A* bound for every spur search, and a spur whose tree path avoids the removed nodes and arcs takes
+// that path without searching. The spur searches of one round run in parallel.
+class KShortestPaths
+{
+public:
+    static std::vector<PathQueryResult> compute(const CompactGraph& graph, unsigned int sourceNodeID, unsigned int targetNodeID, unsigned int pathCount);
+
+private:
+    struct ReverseTree
+    {
+        std::vector<unsigned int> distances;
+        std::vector<unsigned int> nextNodes;
+        std::vector<unsigned int> nextEdges;
+    };
+
+    struct Workspace
+    {
+        std::vector<unsigned int> epochs;
+        std::vector<unsigned int> blocked;
+        std::vector<unsigned int> distances;
+        std::vector<unsigned int> parentNodes;
+        std::vector<unsigned int> parentEdges;
+        QuaternaryHeap            queue;
+        unsigned int              epoch = 0;
+    };
+
+    static void buildReverseTree(const CompactGraph& graph, unsigned int targetNodeID, ReverseTree& tree);
+    static PathQueryResult spurSearch(const CompactGraph& graph, const ReverseTree& tree, const PathQueryResult& previousPath, unsigned int spurIndex
+                                     , const std::vector<unsigned int>& bannedEdges, Workspace& workspace);
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Static k-d tree over points identified by their index. The tree is implicit: every range of m_order holds a
+// subtree whose splitting point sits at the middle, split along the dimension with the widest spread.
+template <unsigned int Dimensions>
+class KdTree
+{
+public:
+    using Point = std::array<double, Dimensions>;
+
+    static constexpr unsigned int kNone = 0xFFFFFFFF;
+
+    void build(std::vector<Point> points)
+    {
+        m_points = std::move(points);
+        m_order.resize(m_points.size());
+        m_splitDimensions.assign(m_points.size(), 0);
+        for (unsigned int index = 0; index < m_order.size(); ++index)
+        {
+            m_order[index] = index;
+        }
+        buildRange(0, static_cast<unsigned int>(m_order.size()));
+    }
+
+    void clear()
+    {
+        m_points.clear();
+        m_order.clear();
+        m_splitDimensions.clear();
+    }
+
+    bool empty() const
+    {
+        return m_points.empty();
+    }
+
+    unsigned int nearest(const Point& query) const
+    {
+        std::vector<unsigned int> result = nearest(query, 1);
+        return result.empty() ? kNone : result.front();
+    }
+
+    // The count closest points, closest first.
+    std::vector<unsigned int> nearest(const Point& query, unsigned int count) const
+    {
+        std::priority_queue<std::pair<double, unsigned int>> best;
+        if (count > 0)
+        {
+            searchRange(0, static_cast<unsigned int>(m_order.size()), query, count, best);
+        }
+
+        std::vector<unsigned int> result(best.size());
+        for (auto it = result.rbegin(); it != result.rend(); ++it)
+        {
+            *it = best.top().second;
+            best.pop();
+        }
+        return result;
+    }
+
+    static double squaredDistance(const Point& first, const Point& second)
+    {
+        double distance = 0.0;
+        for (unsigned int dimension = 0; dimension < Dimensions; ++dimension)
+        {
+            distance += (first[dimension] - second[dimension]) * (first[dimension] - second[dimension]);
+        }
+        return distance;
+    }
+
+private:
+    void buildRange(unsigned int begin, unsigned int end)
+    {
+        if (end - begin <= 1)
+        {
+            return;
+        }
+
+        Point minimum = m_points[m_order[begin]];
+        Point maximum = minimum;
+        for (unsigned int index = begin + 1; index < end; ++index)
+        {
+            for (unsigned int dimension = 0; dimension < Dimensions; ++dimension)
+            {
+                minimum[dimension] = std::min(minimum[dimension], m_points[m_order[index]][dimension]);
+                maximum[dimension] = std::max(maximum[dimension], m_points[m_order[index]][dimension]);
+            }
+        }
+        unsigned int splitDimension = 0;
+        for (unsigned int dimension = 1; dimension < Dimensions; ++dimension)
+        {
+            if (maximum[dimension] - minimum[dimension] > maximum[splitDimension] - minimum[splitDimension])
+            {
+                splitDimension = dimension;
+            }
+        }
+
+        const unsigned int middle = begin + (end - begin) / 2;
+        std::nth_element(m_order.begin() + begin, m_order.begin() + middle, m_order.begin() + end, [&](unsigned int first, unsigned int second)
+        {
+            return m_points[first][splitDimension] < m_points[second][splitDimension];
+        });
+        m_splitDimensions[middle] = splitDimension;
+
+        buildRange(begin, middle);
+        buildRange(middle + 1, end);
+    }
+
+    void searchRange(unsigned int begin, unsigned int end, const Point& query, unsigned int count, std::priority_queue<std::pair<double, unsigned int>>& best) const
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        const unsigned int middle = begin + (end - begin) / 2;
+        const unsigned int pointIndex = m_order[middle];
+        double distance = squaredDistance(query, m_points[pointIndex]);
+        if (best.size() < count)
+        {
+            best.push({ distance, pointIndex });
+        }
+        else if (distance < best.top().first)
+        {
+            best.pop();
+            best.push({ distance, pointIndex });
+        }
+
+        const unsigned int splitDimension = m_splitDimensions[middle];
+        double offset = query[splitDimension] - m_points[pointIndex][splitDimension];
+        bool lowerFirst = offset < 0.0;
+        searchRange(lowerFirst ? begin : middle + 1, lowerFirst ? middle : end, query, count, best);
+        if (best.size() < count || offset * offset < best.top().first)
+        {
+            searchRange(lowerFirst ? middle + 1 : begin, lowerFirst ? end : middle, query, count, best);
+        }
+    }
+
+private:
+    std::vector<Point>        m_points;
+    std::vector<unsigned int> m_order;
+    std::vector<unsigned int> m_splitDimensions;
+};
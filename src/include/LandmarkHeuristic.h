@@ -0,0 +1,46 @@
+#pragma once
+#include "CompactGraph.h"
+#include <string>
+#include <vector>
+
+enum class LandmarkSelection
+{
+    farthest,
+    avoid,
+};
+
+// ALT: lower bounds from the triangle inequality over distances to and from a few landmarks.
+// Tables are node-major so an estimate reads landmarkCount consecutive values.
+class LandmarkHeuristic
+{
+public:
+    static constexpr unsigned int kEstimateUnreachable = 0xFFFFFFFF;
+    // On directed graphs a bound may jump by a landmark distance along a single arc, so A* keys aren't bounded by the weight.
+    static constexpr bool kBoundedKeyIncrease = false;
+
+    LandmarkHeuristic();
+
+    void build(const CompactGraph& graph, unsigned int landmarkCount, LandmarkSelection selection);
+    void clear();
+    bool save(const std::string& filePath, const CompactGraph& graph) const;
+    bool load(const std::string& filePath, const CompactGraph& graph);
+
+    void setTarget(unsigned int targetNodeID);
+    unsigned int estimate(unsigned int nodeID) const;
+    unsigned int lowerBound(unsigned int startNodeID, unsigned int endNodeID) const;
+
+    bool isBuilt() const;
+    const std::vector<unsigned int>& getLandmarks() const;
+
+private:
+    void addLandmark(const CompactGraph& graph, unsigned int landmarkNodeID);
+    unsigned int selectFarthest(const CompactGraph& graph, unsigned int startNodeID) const;
+    unsigned int selectAvoid(const CompactGraph& graph, unsigned int rootNodeID) const;
+
+private:
+    unsigned int              m_nodeCount;
+    unsigned int              m_targetNodeID;
+    std::vector<unsigned int> m_landmarks;
+    std::vector<unsigned int> m_fromLandmark;
+    std::vector<unsigned int> m_toLandmark;
+};
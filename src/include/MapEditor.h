@@ -4,6 +4,18 @@
 #include "Renderer.h"
 #include "TextRenderer.h"
 #include "GraphData.h"
+#include "RouteCache.h"
+#include "KdTree.h"
+
+enum class RoutingAlgorithm
+{
+    dijkstra,
+    bidirectionalDijkstra,
+    aStar,
+    landmarks,
+    contractionHierarchy,
+    customizableHierarchy,
+};
 
 class MapEditor
 {
@@ -15,6 +27,15 @@ public:
 
     void loadFromFile(const std::string& filePath);
     void findMinDistance();
+    void findAlternativeRoutes(unsigned int routeCount);
+    void reportRoutingBenchmark(unsigned int sampleQueries);
+    void applyTrafficUpdate(float affectedShare);
+    void showIsochrone(unsigned int maxDistance);
+    void exportDistanceTable(unsigned int endpointCount, const std::string& filePath);
+    void routeBetweenCoordinates(GeoCoordinate start, GeoCoordinate end);
+    unsigned int findNearestNode(GeoCoordinate coordinate) const;
+    void setRoutingAlgorithm(RoutingAlgorithm algorithm);
+    RoutingAlgorithm getRoutingAlgorithm() const;
 
     GraphData& getGraphData();
     const GraphNode* const getSelectedNode() const;
@@ -23,12 +44,25 @@ public:
 private:
     glm::vec2 convertToScreenCoordinates(double latitude, double longitude, int screenWidth, int screenHeight);
     void checkNodeSelect(glm::vec2 position);
+    GraphNode* findNodeAt(glm::vec2 position);
+    void prepareRoutingIndex(RoutingAlgorithm algorithm);
 private:
     static constexpr float kNodeRadius = 30.0f;
+    static constexpr float kSelectionRadius = 15.0f;
+    static constexpr unsigned int kLandmarkCount = 16;
+    static constexpr unsigned int kRouteCacheCapacity = 1024;
 private:
     GraphNode* m_leftClickSelectedNode;
     GraphNode* m_rightClickSelectedNode;
 
+    RoutingAlgorithm m_routingAlgorithm;
+    std::string      m_mapFilePath;
+    std::vector<int> m_freeFlowWeights;
+    bool             m_trafficApplied;
+    RouteCache       m_routeCache;
+    KdTree<2>        m_screenTree;
+    KdTree<3>        m_geoTree;
+
     GraphData m_graphData;
     Renderer m_renderer;
 };
\ No newline at end of file
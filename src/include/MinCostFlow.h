@@ -0,0 +1,50 @@
+#pragma once
+#include "Edge.h"
+#include "PriorityQueues.h"
+#include <limits>
+#include <vector>
+
+struct MinCostFlowResult
+{
+    long long        flow          = 0;
+    long long        cost          = 0;
+    unsigned int     augmentations = 0;
+    bool             feasible      = true;   // false when a negative cycle is reachable from the source or the input is invalid
+    std::vector<int> edgeFlows;               // net flow along every edge, in edge order
+};
+
+// Successive shortest paths on a CSR residual graph with separate capacity and cost arrays. Johnson potentials keep the
+// reduced costs non-negative, so every augmentation is one Dijkstra; Bellman-Ford runs once, only when costs are negative.
+class MinCostFlow
+{
+public:
+    static constexpr long long kUnlimitedFlow = std::numeric_limits<long long>::max();
+
+    MinCostFlow();
+
+    // Edge weights are the capacities, costs are given per edge; an undirected edge becomes an arc each way.
+    void build(unsigned int nodeCount, const std::vector<Edge>& edges, bool oriented, const std::vector<int>& costs);
+    MinCostFlowResult solve(unsigned int sourceNodeID, unsigned int sinkNodeID, long long flowLimit = kUnlimitedFlow);
+
+private:
+    bool initializePotentials(unsigned int sourceNodeID);
+    bool findShortestPath(unsigned int sourceNodeID, unsigned int sinkNodeID);
+
+private:
+    unsigned int              m_nodeCount;
+    unsigned int              m_edgeCount;
+    bool                      m_hasNegativeCosts;
+    std::vector<unsigned int> m_offsets;
+    std::vector<unsigned int> m_heads;
+    std::vector<int>          m_capacities;
+    std::vector<int>          m_costs;
+    std::vector<unsigned int> m_reverseArcs;
+    std::vector<unsigned int> m_edgeArcs;         // forward arcs of every edge, two per edge
+    std::vector<int>          m_residual;
+
+    std::vector<long long>    m_potentials;
+    std::vector<unsigned int> m_distances;
+    std::vector<unsigned int> m_parentArcs;
+    std::vector<bool>         m_settled;
+    QuaternaryHeap            m_queue;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+
+inline unsigned int getParallelThreadCount()
+{
+    return ThreadPool::getShared().getThreadCount();
+}
+
+// Splits [begin, end) into chunks of grainSize handed out dynamically to the threads of the shared pool.
+// The function receives (threadIndex, chunkBegin, chunkEnd), threadIndex < getParallelThreadCount().
+// Nested calls, and calls made while another thread holds the pool, run every chunk on the calling thread.
+template <typename Function>
+void parallelForChunks(unsigned int begin, unsigned int end, unsigned int grainSize, Function&& function)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    grainSize = std::max(1u, grainSize);
+    const unsigned int chunkCount = (end - begin + grainSize - 1) / grainSize;
+    const unsigned int threadCount = std::min(getParallelThreadCount(), chunkCount);
+
+    if (threadCount <= 1)
+    {
+        function(0u, begin, end);
+        return;
+    }
+
+    std::atomic<unsigned int> nextChunk{ 0 };
+    auto worker = [&](unsigned int threadIndex)
+    {
+        for (unsigned int chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1))
+        {
+            unsigned int chunkBegin = begin + chunk * grainSize;
+            unsigned int chunkEnd = std::min(end, chunkBegin + grainSize);
+            function(threadIndex, chunkBegin, chunkEnd);
+        }
+    };
+
+    if (!ThreadPool::getShared().run(threadCount, worker))
+    {
+        worker(0);
+    }
+}
+
+template <typename Function>
+void parallelFor(unsigned int begin, unsigned int end, Function&& function, unsigned int grainSize = 1024)
+{
+    parallelForChunks(begin, end, grainSize, [&](unsigned int, unsigned int chunkBegin, unsigned int chunkEnd)
+    {
+        for (unsigned int index = chunkBegin; index < chunkEnd; ++index)
+        {
+            function(index);
+        }
+    });
+}
@@ -0,0 +1,279 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Queue policies used by the shortest path engine and Prim. Every policy stores (key, nodeID) pairs and exposes
+// reset(nodeCount, maxArcWeight), empty(), push(nodeID, key) and pop() -> (key, nodeID).
+// push is called again with a smaller key when a node improves: the indexed heap decreases the key in place,
+// the other policies keep the stale entry and the caller skips it once it is popped.
+
+class LazyBinaryHeap
+{
+public:
+    static constexpr bool kMonotoneOnly = false;
+
+    void reset(unsigned int, unsigned int)
+    {
+        m_heap = {};
+    }
+
+    bool empty() const
+    {
+        return m_heap.empty();
+    }
+
+    void push(unsigned int nodeID, unsigned int key)
+    {
+        m_heap.emplace(key, nodeID);
+    }
+
+    std::pair<unsigned int, unsigned int> pop()
+    {
+        auto top = m_heap.top();
+        m_heap.pop();
+        return top;
+    }
+
+private:
+    using Pair = std::pair<unsigned int, unsigned int>;
+    std::priority_queue<Pair, std::vector<Pair>, std::greater<>> m_heap;
+};
+
+class QuaternaryHeap
+{
+public:
+    static constexpr bool kMonotoneOnly = false;
+
+    void reset(unsigned int nodeCount, unsigned int)
+    {
+        m_heap.clear();
+        if (m_positions.size() < nodeCount)
+        {
+            m_positions.resize(nodeCount, 0);
+        }
+    }
+
+    bool empty() const
+    {
+        return m_heap.empty();
+    }
+
+    bool contains(unsigned int nodeID) const
+    {
+        unsigned int position = m_positions[nodeID];
+        return position < m_heap.size() && m_heap[position].second == nodeID;
+    }
+
+    void push(unsigned int nodeID, unsigned int key)
+    {
+        if (contains(nodeID))
+        {
+            unsigned int position = m_positions[nodeID];
+            if (key < m_heap[position].first)
+            {
+                m_heap[position].first = key;
+                siftUp(position);
+            }
+            return;
+        }
+
+        m_heap.emplace_back(key, nodeID);
+        m_positions[nodeID] = static_cast<unsigned int>(m_heap.size() - 1);
+        siftUp(static_cast<unsigned int>(m_heap.size() - 1));
+    }
+
+    std::pair<unsigned int, unsigned int> pop()
+    {
+        auto top = m_heap.front();
+        m_heap.front() = m_heap.back();
+        m_positions[m_heap.front().second] = 0;
+        m_heap.pop_back();
+
+        if (!m_heap.empty())
+        {
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    static constexpr unsigned int kArity = 4;
+
+    void siftUp(unsigned int position)
+    {
+        auto entry = m_heap[position];
+        while (position > 0)
+        {
+            unsigned int parent = (position - 1) / kArity;
+            if (m_heap[parent].first <= entry.first)
+            {
+                break;
+            }
+            m_heap[position] = m_heap[parent];
+            m_positions[m_heap[position].second] = position;
+            position = parent;
+        }
+        m_heap[position] = entry;
+        m_positions[entry.second] = position;
+    }
+
+    void siftDown(unsigned int position)
+    {
+        auto entry = m_heap[position];
+        const unsigned int size = static_cast<unsigned int>(m_heap.size());
+        while (true)
+        {
+            unsigned int firstChild = position * kArity + 1;
+            if (firstChild >= size)
+            {
+                break;
+            }
+
+            unsigned int smallest = firstChild;
+            unsigned int lastChild = std::min(firstChild + kArity, size);
+            for (unsigned int child = firstChild + 1; child < lastChild; ++child)
+            {
+                if (m_heap[child].first < m_heap[smallest].first)
+                {
+                    smallest = child;
+                }
+            }
+
+            if (entry.first <= m_heap[smallest].first)
+            {
+                break;
+            }
+            m_heap[position] = m_heap[smallest];
+            m_positions[m_heap[position].second] = position;
+            position = smallest;
+        }
+        m_heap[position] = entry;
+        m_positions[entry.second] = position;
+    }
+
+private:
+    std::vector<std::pair<unsigned int, unsigned int>> m_heap;
+    std::vector<unsigned int>                          m_positions;
+};
+
+// Monotone: keys pushed are never smaller than the last popped key, which holds for Dijkstra with non-negative weights.
+class RadixHeap
+{
+public:
+    static constexpr bool kMonotoneOnly = true;
+
+    void reset(unsigned int, unsigned int)
+    {
+        for (auto& bucket : m_buckets)
+        {
+            bucket.clear();
+        }
+        m_size = 0;
+        m_lastKey = 0;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void push(unsigned int nodeID, unsigned int key)
+    {
+        m_buckets[getBucket(key)].emplace_back(key, nodeID);
+        ++m_size;
+    }
+
+    std::pair<unsigned int, unsigned int> pop()
+    {
+        if (m_buckets[0].empty())
+        {
+            unsigned int bucketIndex = 1;
+            while (m_buckets[bucketIndex].empty())
+            {
+                ++bucketIndex;
+            }
+
+            auto& bucket = m_buckets[bucketIndex];
+            m_lastKey = std::min_element(bucket.begin(), bucket.end())->first;
+            for (const auto& entry : bucket)
+            {
+                m_buckets[getBucket(entry.first)].push_back(entry);
+            }
+            bucket.clear();
+        }
+
+        auto top = m_buckets[0].back();
+        m_buckets[0].pop_back();
+        --m_size;
+        return top;
+    }
+
+private:
+    unsigned int getBucket(unsigned int key) const
+    {
+        return static_cast<unsigned int>(std::bit_width(key ^ m_lastKey));
+    }
+
+private:
+    std::vector<std::pair<unsigned int, unsigned int>> m_buckets[33];
+    unsigned int m_size    = 0;
+    unsigned int m_lastKey = 0;
+};
+
+// Dial's buckets: a circular array of maxArcWeight + 1 buckets covers every key that can be pending at once.
+class DialBuckets
+{
+public:
+    static constexpr bool kMonotoneOnly = true;
+
+    void reset(unsigned int, unsigned int maxArcWeight)
+    {
+        if (m_buckets.size() != static_cast<std::size_t>(maxArcWeight) + 1)
+        {
+            m_buckets.assign(static_cast<std::size_t>(maxArcWeight) + 1, {});
+        }
+        else
+        {
+            for (auto& bucket : m_buckets)
+            {
+                bucket.clear();
+            }
+        }
+        m_size = 0;
+        m_currentKey = 0;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void push(unsigned int nodeID, unsigned int key)
+    {
+        m_buckets[key % m_buckets.size()].push_back(nodeID);
+        ++m_size;
+    }
+
+    std::pair<unsigned int, unsigned int> pop()
+    {
+        while (m_buckets[m_currentKey % m_buckets.size()].empty())
+        {
+            ++m_currentKey;
+        }
+
+        auto& bucket = m_buckets[m_currentKey % m_buckets.size()];
+        unsigned int nodeID = bucket.back();
+        bucket.pop_back();
+        --m_size;
+        return { m_currentKey, nodeID };
+    }
+
+private:
+    std::vector<std::vector<unsigned int>> m_buckets;
+    unsigned int m_size       = 0;
+    unsigned int m_currentKey = 0;
+};
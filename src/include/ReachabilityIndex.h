@@ -0,0 +1,53 @@
+#pragma once
+#include "CompactGraph.h"
+#include <utility>
+#include <vector>
+
+// Reachability queries over the condensation of the graph, in the GRAIL style: every component gets one interval per
+// randomized post-order traversal, [lowest post-order number below it, its own post-order number]. If u reaches v,
+// every interval of v nests in the matching interval of u, so one non-nested pair answers "no" at once. The DFS tree
+// of the first traversal answers "yes" for tree descendants; anything else falls back to a DFS pruned by the intervals.
+class ReachabilityIndex
+{
+public:
+    static constexpr unsigned int kDefaultTraversalCount = 4;
+
+    ReachabilityIndex();
+
+    void build(const CompactGraph& graph, unsigned int traversalCount = kDefaultTraversalCount);
+    void clear();
+    bool isBuilt() const;
+
+    bool canReach(unsigned int sourceNodeID, unsigned int targetNodeID);
+
+    unsigned int getComponent(unsigned int nodeID) const;
+    unsigned int getComponentCount() const;
+    unsigned int getFallbackSearches() const;
+
+private:
+    struct Interval
+    {
+        unsigned int low;
+        unsigned int post;
+    };
+
+    void computeComponents(const CompactGraph& graph);
+    void buildCondensation(const CompactGraph& graph);
+    void labelTraversal(unsigned int traversal, unsigned int seed);
+    bool mayReach(unsigned int sourceComponent, unsigned int targetComponent) const;
+
+private:
+    unsigned int              m_nodeCount;
+    unsigned int              m_componentCount;
+    unsigned int              m_traversalCount;
+    std::vector<unsigned int> m_components;
+    std::vector<unsigned int> m_offsets;
+    std::vector<unsigned int> m_targets;
+    std::vector<Interval>     m_intervals;   // m_traversalCount per component
+    std::vector<unsigned int> m_treeStarts;  // first post-order number in the component's subtree of traversal 0
+
+    std::vector<unsigned int> m_epochs;
+    std::vector<unsigned int> m_stack;
+    unsigned int              m_epoch;
+    unsigned int              m_fallbackSearches;
+};
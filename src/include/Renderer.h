@@ -38,16 +38,23 @@ public:
     void clearEdgeBatch();
     void edgeInstanceRender(Shader& shader);
 
+    // uploaded once per change, then drawn every frame in a single color over the edge batch
+    void setHighlightedEdges(const std::vector<const Edge*>& edges);
+    void highlightedEdgesRender(Shader& shader, glm::vec4 color);
+
 private:
     void initPrimitivesData();
     void initCircleData();
     void initQuadData();
     void initLineData();
+    void initHighlightData();
 private:
     TextRenderer m_textRenderer;
     Primitive    m_circle;
     Primitive    m_quad;
     Primitive    m_line;
+    Primitive    m_highlight;
+    unsigned int m_highlightVertexCount;
 
     unsigned int m_linesDataVBO;
     std::vector<float> m_linesData;
@@ -0,0 +1,38 @@
+#pragma once
+#include "ShortestPathEngine.h"
+#include <list>
+#include <unordered_map>
+
+// Bounded LRU cache of route results. Entries belong to one graph version: a lookup or insert with another
+// version drops everything, so any weight or topology change invalidates the cache without extra bookkeeping.
+class RouteCache
+{
+public:
+    explicit RouteCache(unsigned int capacity);
+
+    const PathQueryResult* find(unsigned int sourceNodeID, unsigned int targetNodeID, unsigned long long graphVersion);
+    void insert(unsigned int sourceNodeID, unsigned int targetNodeID, unsigned long long graphVersion, const PathQueryResult& result);
+    void clear();
+
+    unsigned long long getHits()   const;
+    unsigned long long getMisses() const;
+    unsigned int       getSize()   const;
+
+private:
+    struct Entry
+    {
+        unsigned long long key;
+        PathQueryResult    result;
+    };
+
+    static unsigned long long makeKey(unsigned int sourceNodeID, unsigned int targetNodeID);
+    void synchronize(unsigned long long graphVersion);
+
+private:
+    unsigned int       m_capacity;
+    unsigned long long m_graphVersion;
+    unsigned long long m_hits;
+    unsigned long long m_misses;
+    std::list<Entry>   m_entries;   // most recently used first
+    std::unordered_map<unsigned long long, std::list<Entry>::iterator> m_index;
+};
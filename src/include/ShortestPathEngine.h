@@ -0,0 +1,98 @@
+#pragma once
+#include "CompactGraph.h"
+#include "GeoHeuristic.h"
+#include "LandmarkHeuristic.h"
+#include "PriorityQueues.h"
+#include <limits>
+#include <tuple>
+#include <vector>
+
+struct PathQueryResult
+{
+    static constexpr unsigned int kUnreachable = std::numeric_limits<unsigned int>::max();
+
+    unsigned int              distance     = kUnreachable;
+    unsigned int              settledNodes = 0;
+    std::vector<unsigned int> path;
+    std::vector<unsigned int> edges;
+
+    bool isReachable() const { return distance != kUnreachable; }
+};
+
+enum class QueuePolicy
+{
+    lazyBinaryHeap,
+    quaternaryHeap,
+    radixHeap,
+    dialBuckets,
+};
+
+class ShortestPathEngine
+{
+public:
+    explicit ShortestPathEngine(const CompactGraph& graph);
+
+    PathQueryResult query(unsigned int sourceNodeID, unsigned int targetNodeID);
+
+    template <typename PriorityQueue>
+    PathQueryResult query(unsigned int sourceNodeID, unsigned int targetNodeID);
+
+    PathQueryResult bidirectionalQuery(unsigned int sourceNodeID, unsigned int targetNodeID);
+
+    template <typename Heuristic>
+    PathQueryResult aStarQuery(unsigned int sourceNodeID, unsigned int targetNodeID, const Heuristic& heuristic);
+
+    template <typename PriorityQueue, typename Heuristic>
+    PathQueryResult aStarQuery(unsigned int sourceNodeID, unsigned int targetNodeID, const Heuristic& heuristic);
+
+    template <typename PriorityQueue>
+    PathQueryResult bidirectionalQuery(unsigned int sourceNodeID, unsigned int targetNodeID);
+
+    // Settles every node within maxDistance of the source and reports (nodeID, distance) in settling order.
+    void rangeQuery(unsigned int sourceNodeID, unsigned int maxDistance, std::vector<std::pair<unsigned int, unsigned int>>& reachedNodes);
+
+    void setQueuePolicy(QueuePolicy policy);
+    QueuePolicy getQueuePolicy() const;
+    QueuePolicy benchmarkQueuePolicies(unsigned int sampleQueries);
+
+    static const char* getQueuePolicyName(QueuePolicy policy);
+
+    // One-to-all search over the out-arcs, or over the in-arcs when reverse is set. Unreached nodes keep kUnreachable.
+    static void computeDistances(const CompactGraph& graph, unsigned int sourceNodeID, bool reverse, std::vector<unsigned int>& distances
+                                , std::vector<unsigned int>* parentNodes = nullptr, std::vector<unsigned int>* settledOrder = nullptr);
+
+private:
+    static constexpr unsigned int kForward  = 0;
+    static constexpr unsigned int kBackward = 1;
+
+    struct SearchSpace
+    {
+        std::vector<unsigned int> epochs;
+        std::vector<unsigned int> distances;
+        std::vector<unsigned int> parentNodes;
+        std::vector<unsigned int> parentEdges;
+    };
+
+    void startQuery();
+    bool isLabeled(unsigned int direction, unsigned int nodeID) const;
+    unsigned int getDistance(unsigned int direction, unsigned int nodeID) const;
+    void label(unsigned int direction, unsigned int nodeID, unsigned int distance, unsigned int parentNodeID, unsigned int parentEdge);
+    PathQueryResult extractPath(unsigned int sourceNodeID, unsigned int targetNodeID, unsigned int meetingNodeID, unsigned int settledNodes) const;
+    bool canUseDialBuckets() const;
+
+    template <typename Function>
+    PathQueryResult dispatchQueuePolicy(Function&& function, bool boundedKeyIncrease = true);
+
+    template <typename PriorityQueue>
+    PriorityQueue& getQueue(unsigned int direction);
+
+private:
+    static constexpr unsigned int kMaxDialBuckets = 1 << 16;
+
+    const CompactGraph& m_graph;
+    QueuePolicy         m_queuePolicy;
+
+    unsigned int m_epoch;
+    SearchSpace  m_searchSpaces[2];
+    std::tuple<LazyBinaryHeap, QuaternaryHeap, RadixHeap, DialBuckets> m_queues[2];
+};
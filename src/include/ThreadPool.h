@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads started once and parked between jobs, so short parallel phases do not pay for creating threads.
+// A job runs task(threadIndex) for every threadIndex < threadCount, index 0 on the calling thread.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned int threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static ThreadPool& getShared();
+
+    // Counts the calling thread.
+    unsigned int getThreadCount() const;
+
+    // Returns false without running anything when called from inside a job or while another thread owns the pool;
+    // the caller then does the work itself.
+    template <typename Task>
+    bool run(unsigned int threadCount, Task& task)
+    {
+        return runTask(threadCount, [](void* context, unsigned int threadIndex) { (*static_cast<Task*>(context))(threadIndex); }, &task);
+    }
+
+private:
+    using TaskFunction = void (*)(void*, unsigned int);
+
+    bool runTask(unsigned int threadCount, TaskFunction task, void* context);
+    void workerLoop(unsigned int threadIndex);
+
+private:
+    std::vector<std::thread>            m_workers;
+    std::mutex                          m_runMutex;
+    std::mutex                          m_mutex;
+    std::condition_variable             m_wakeCondition;
+    std::condition_variable             m_doneCondition;
+    unsigned long long                  m_generation;
+    std::atomic<unsigned int>           m_pendingWorkers;
+    bool                                m_stopping;
+    unsigned int                        m_activeThreads;
+    TaskFunction                        m_task;
+    void*                               m_context;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <vector>
+
+class UnionFind
+{
+public:
+    UnionFind(unsigned int size = 0);
+
+    void reset(unsigned int size);
+    unsigned int addElement();
+
+    unsigned int find(unsigned int element);
+    bool unite(unsigned int first, unsigned int second);
+
+    unsigned int getSize() const;
+    unsigned int getComponentCount() const;
+
+private:
+    std::vector<unsigned int> m_parents;
+    std::vector<unsigned int> m_ranks;
+    unsigned int              m_componentCount;
+};